@@ -2,8 +2,13 @@ declare namespace torch {
 
   type ArrayTypes =
     | Float32Array
+    | Float64Array
     | Int32Array
+    | Int16Array
+    | Int8Array
     | Uint8Array
+    | Uint16Array
+    | Uint32Array
     | BigInt64Array
     | boolean[] | number[];
 
@@ -28,6 +33,13 @@ declare namespace torch {
     uint8: "uint8",
     long: "long",
     bool: "bool",
+    float16: "float16",
+    bfloat16: "bfloat16",
+    int8: "int8",
+    int16: "int16",
+    qint8: "qint8",
+    quint8: "quint8",
+    qint32: "qint32",
   };
 
   type TensorTypes = typeof types[keyof typeof types];
@@ -40,6 +52,14 @@ declare namespace torch {
     ? typeof types.int32
     : T extends Uint8Array
     ? typeof types.uint8
+    : T extends Int8Array
+    ? typeof types.int8
+    : T extends Int16Array
+    ? typeof types.int16
+    : T extends Uint16Array
+    ? typeof types.int32
+    : T extends Uint32Array
+    ? typeof types.long
     : T extends BigInt64Array
     ? typeof types.long
     : T extends boolean[]
@@ -58,6 +78,12 @@ declare namespace torch {
     ? Uint8Array
     : T extends typeof types.long
     ? BigInt64Array
+    : T extends typeof types.int8
+    ? Int8Array
+    : T extends typeof types.int16
+    ? Int16Array
+    : T extends typeof types.float16 | typeof types.bfloat16
+    ? Uint16Array
     : T extends typeof types.bool
     ? boolean[]
     : ArrayTypes;
@@ -66,9 +92,31 @@ declare namespace torch {
     ? MultiDim<boolean>
     : MultiDim<number>;
 
+  type SharedTensorDescriptor<T extends TensorTypes = TensorTypes> = {
+    buffer: SharedArrayBuffer;
+    dtype: T;
+    shape: number[];
+    /** In elements */
+    strides: number[];
+    /** In elements */
+    offset: number;
+  };
+
+  // Writes the result into an existing tensor instead of allocating a new one
+  type OutOptions = { out: Tensor };
+
+  type MemoryFormats = "contiguous" | "channelsLast" | "channelsLast3d";
+
+  type SerializeOptions = {
+    compress?: "none" | "zlib";
+    /** Floating point tensors only, deserialize restores the original dtype */
+    quantize?: "none" | "fp16" | "int8";
+  };
+
   declare class Tensor<TensorType extends TensorTypes = TensorTypes> {
     shape: number[];
 
+    /** float16 and bfloat16 come back as their raw bits in a Uint16Array */
     toArray: () => TensorTypeToArrayType<TensorType>;
 
     reshape: (view: number[]) => Tensor<TensorType>;
@@ -79,30 +127,74 @@ declare namespace torch {
 
     dtype: TensorType;
 
+    /**
+     * Uint16Array becomes int32 and Uint32Array long, as libtorch has no unsigned wider than 8 bits.
+     * With dtype float16 or bfloat16 a Uint16Array is taken as raw half precision bits, anything else is converted
+     */
+    static fromTypedArray<T extends TensorTypes>(data: ArrayTypes, shape: number[], dtype: T): Tensor<T>;
     static fromTypedArray(data: ArrayTypes, shape: number[]);
 
-    // toMultiArray: () => MultiDimType<TensorType>;
+    /** Views the descriptor's SharedArrayBuffer without copying, writes are visible to every thread */
+    static fromShared<T extends TensorTypes = TensorTypes>(descriptor: SharedTensorDescriptor<T>): Tensor<T>;
+
+    /** Copies once into a SharedArrayBuffer, the descriptor can be posted to worker_threads */
+    toShared: () => { tensor: Tensor<TensorType>; descriptor: SharedTensorDescriptor<TensorType> };
+
+    /** One self delimiting frame, frames can be concatenated */
+    serialize: (options?: SerializeOptions) => Buffer;
+
+    /** Uncompressed, unquantized frames view the buffer in place */
+    static deserialize(buffer: Uint8Array): Tensor;
+
+    /** Bytes of the frame at the start of buffer, null until its header has arrived */
+    static frameLength(buffer: Uint8Array): number | null;
+
+    /** Plain nested arrays for JSON and friends, long above 2^53 loses precision and quantized tensors are dequantized */
+    toNestedArray: () => MultiDimType<TensorType>;
+
+    /** The shape is taken from the first element at every depth and must be regular. Numbers default to float, booleans to bool, bigints to long */
+    static fromNestedArray<T extends TensorTypes = TensorTypes>(data: MultiDim<number | boolean | bigint> | number[] | boolean[], dtype?: T): Tensor<T>;
 
     squeeze: (dim: number) => Tensor<TensorType>;
 
     unsqueeze: (dim: number) => Tensor<TensorType>;
 
     add: <T extends TensorTypes = typeof types.float>(
-      a: Tensor<T> | number
+      a: Tensor<T> | number,
+      options?: OutOptions
     ) => Tensor;
 
-    sub: <T extends TensorTypes = typeof types.float>(
+    add_: <T extends TensorTypes = typeof types.float>(
       a: Tensor<T> | number
+    ) => this;
+
+    sub: <T extends TensorTypes = typeof types.float>(
+      a: Tensor<T> | number,
+      options?: OutOptions
     ) => Tensor;
 
-    mul: <T extends TensorTypes = typeof types.float>(
+    sub_: <T extends TensorTypes = typeof types.float>(
       a: Tensor<T> | number
+    ) => this;
+
+    mul: <T extends TensorTypes = typeof types.float>(
+      a: Tensor<T> | number,
+      options?: OutOptions
     ) => Tensor;
 
-    div: <T extends TensorTypes = typeof types.float>(
+    mul_: <T extends TensorTypes = typeof types.float>(
       a: Tensor<T> | number
+    ) => this;
+
+    div: <T extends TensorTypes = typeof types.float>(
+      a: Tensor<T> | number,
+      options?: OutOptions
     ) => Tensor;
 
+    div_: <T extends TensorTypes = typeof types.float>(
+      a: Tensor<T> | number
+    ) => this;
+
     get: (...operators: TorchIndexOperators[]) => Tensor<TensorType>;
 
     set: <T extends TensorTypes = TensorType>(value: Tensor<T>,
@@ -124,6 +216,66 @@ declare namespace torch {
       keepDim: boolean = false
     ) => [Tensor<TensorType>, Tensor<typeof types.int32>];
 
+    /** [values, indices] of the k largest (or smallest) entries along dim */
+    topk: (
+      k: number,
+      dim?: number,
+      largest?: boolean,
+      sorted?: boolean
+    ) => [Tensor<TensorType>, Tensor<typeof types.long>];
+
+    topkAsync: (
+      k: number,
+      dim?: number,
+      largest?: boolean,
+      sorted?: boolean
+    ) => Promise<[Tensor<TensorType>, Tensor<typeof types.long>]>;
+
+    kthvalue: (
+      k: number,
+      dim?: number,
+      keepDim?: boolean
+    ) => [Tensor<TensorType>, Tensor<typeof types.long>];
+
+    kthvalueAsync: (
+      k: number,
+      dim?: number,
+      keepDim?: boolean
+    ) => Promise<[Tensor<TensorType>, Tensor<typeof types.long>]>;
+
+    softmax: (dim?: number) => Tensor<TensorType>;
+
+    softmaxAsync: (dim?: number) => Promise<Tensor<TensorType>>;
+
+    logSoftmax: (dim?: number) => Tensor<TensorType>;
+
+    logSoftmaxAsync: (dim?: number) => Promise<Tensor<TensorType>>;
+
+    multinomial: (
+      numSamples: number,
+      replacement?: boolean,
+      generator?: Generator
+    ) => Tensor<typeof types.long>;
+
+    multinomialAsync: (
+      numSamples: number,
+      replacement?: boolean,
+      generator?: Generator
+    ) => Promise<Tensor<typeof types.long>>;
+
+    /** Samples one token id per row of logits from the smallest set of tokens whose probability reaches p */
+    sampleTopP: (
+      p: number,
+      temperature?: number,
+      generator?: Generator
+    ) => Tensor<typeof types.long>;
+
+    sampleTopPAsync: (
+      p: number,
+      temperature?: number,
+      generator?: Generator
+    ) => Promise<Tensor<typeof types.long>>;
+
     view: (...dims: number[]) => Tensor<TensorType>;
 
     any: (
@@ -133,9 +285,13 @@ declare namespace torch {
       TensorType extends typeof types.uint8 ? TensorType : typeof types.bool
     >;
 
-    clamp: (min: number, max: number) => Tensor<TensorType>;
+    clamp: (min: number, max: number, options?: OutOptions) => Tensor<TensorType>;
+
+    clamp_: (min: number, max: number) => this;
 
-    sigmoid: () => Tensor<TensorType>;
+    sigmoid: (options?: OutOptions) => Tensor<TensorType>;
+
+    sigmoid_: () => this;
 
     cuda: () => Tensor<TensorType>;
 
@@ -145,6 +301,32 @@ declare namespace torch {
 
     backward: () => void;
 
+    /** channelsLast keeps the logical NCHW shape and strides the data as NHWC */
+    contiguous: (options?: { memoryFormat?: MemoryFormats }) => Tensor<TensorType>;
+
+    isContiguous: (options?: { memoryFormat?: MemoryFormats }) => boolean;
+
+    /** The layout results derived from this tensor will use */
+    memoryFormat: MemoryFormats;
+
+    /** oneDNN blocked layout, float tensors only, toDense converts back */
+    toMkldnn: () => Tensor<TensorType>;
+
+    toDense: () => Tensor<TensorType>;
+
+    dequantize: () => Tensor<typeof types.float>;
+
+    /** The stored integers of a quantized tensor, which is also what toArray returns for one */
+    intRepr: () => Tensor;
+
+    /** Per channel quantization returns one value per channel */
+    qScale: () => number | Tensor<typeof types.double>;
+
+    qZeroPoint: () => number | Tensor<typeof types.long>;
+
+    /** Releases the storage now, pooled buffers go back to their TensorPool */
+    dispose: () => void;
+
     *[Symbol.iterator](): IterableIterator<Tensor<TensorType>>;
   }
 
@@ -153,6 +335,12 @@ declare namespace torch {
     shape?: number[]
   ): Tensor<ArrayTypeToTensorType<T>>;
 
+  declare function tensor<T extends TensorTypes = typeof types.float>(
+    data: MultiDim<number | boolean | bigint>,
+    shape?: number[],
+    dtype?: T
+  ): Tensor<T>;
+
   declare function rand<T extends TensorTypes = typeof types.float>(
     shape: number[],
     dtype?: T
@@ -226,6 +414,243 @@ declare namespace torch {
 
   declare function runBlockingAsync<Result = unknown, Args extends unknown[]>(func: (...args: Args) => Result, ...args: Args): Promise<Result>
 
+  declare class Generator {
+    /** Seeds from a non deterministic source when no seed is given */
+    constructor(seed?: number);
+
+    manualSeed(seed: number): this;
+
+    /** Reseeds non deterministically and returns the new seed */
+    seed(): number;
+
+    initialSeed(): number;
+  }
+
+  type MemoryStats = {
+    hits: number;
+    misses: number;
+    evictions: number;
+    buffersCached: number;
+    bytesCached: number;
+    bytesInUse: number;
+  };
+
+  type CacheLimits = {
+    /** Total idle bytes kept before released buffers are freed */
+    maxBytes?: number;
+    /** Idle buffers kept per size class */
+    maxPerClass?: number;
+  };
+
+  declare class TensorPool {
+    constructor(options?: CacheLimits);
+
+    empty<T extends TensorTypes = typeof types.float>(shape: number[], dtype?: T): Tensor<T>;
+
+    zeros<T extends TensorTypes = typeof types.float>(shape: number[], dtype?: T): Tensor<T>;
+
+    /** Converts like Tensor.fromTypedArray, including raw half precision bits in a Uint16Array */
+    fromTypedArray<T extends ArrayTypes = ArrayTypes>(data: T, shape?: number[]): Tensor<ArrayTypeToTensorType<T>>;
+    fromTypedArray<T extends TensorTypes>(data: ArrayTypes, shape: number[] | undefined, dtype: T): Tensor<T>;
+
+    stats(): MemoryStats;
+
+    /** Frees idle buffers, buffers still in use return to the pool as usual */
+    clear(): void;
+  }
+
+  /** Process wide caching allocator for every CPU tensor torch allocates */
+  namespace allocator {
+    declare function enable(options?: CacheLimits & { minBytes?: number }): void;
+    declare function disable(): void;
+    declare function stats(): MemoryStats & { enabled: boolean };
+  }
+
+  namespace index {
+    type Metric = "ip" | "l2" | "cosine";
+
+    type SearchResult = {
+      /** Similarity for 'ip' and 'cosine', squared distance for 'l2', [queries, k] */
+      distances: Tensor<typeof types.float>;
+      /** -1 where fewer than k vectors were found */
+      ids: Tensor<typeof types.long>;
+    };
+
+    type IndexOptions = {
+      dim: number;
+      metric?: Metric;
+      dtype?: typeof types.float | typeof types.double;
+    };
+
+    declare class FlatIndex {
+      constructor(options: IndexOptions);
+
+      size: number;
+      dim: number;
+      metric: Metric;
+
+      /** Resolves with the ids of the added vectors, counted up from the largest id so far when none are given */
+      add(vectors: Tensor, ids?: Tensor | number[]): Promise<Tensor<typeof types.long>>;
+
+      /** Resolves with the number of vectors removed */
+      remove(ids: Tensor | number[]): Promise<number>;
+
+      search(queries: Tensor, k?: number): Promise<SearchResult>;
+
+      save(path: string): Promise<void>;
+    }
+
+    declare class IVFIndex {
+      constructor(options: IndexOptions & { nlist?: number; nprobe?: number });
+
+      size: number;
+      dim: number;
+      metric: Metric;
+      trained: boolean;
+      /** Lists scanned per query */
+      nprobe: number;
+
+      /** k-means over the vectors, existing vectors are moved to the new lists */
+      train(vectors: Tensor, options?: { iterations?: number; seed?: number }): Promise<void>;
+
+      add(vectors: Tensor, ids?: Tensor | number[]): Promise<Tensor<typeof types.long>>;
+
+      remove(ids: Tensor | number[]): Promise<number>;
+
+      search(queries: Tensor, k?: number): Promise<SearchResult>;
+
+      save(path: string): Promise<void>;
+    }
+
+    declare function load(path: string): Promise<FlatIndex | IVFIndex>;
+  }
+
+  /** Float32Array input is read in place, it must not be transferred or changed until the promise settles */
+  namespace audio {
+    type Signal = Float32Array | Tensor;
+
+    type SpectrogramOptions = {
+      nFft?: number;
+      /** Defaults to nFft */
+      winLength?: number;
+      /** Defaults to winLength / 2 */
+      hopLength?: number;
+      center?: boolean;
+      /** null returns the complex result as [..., 2] */
+      power?: number | null;
+      window?: "hann" | "hamming" | "rect";
+    };
+
+    type MelOptions = SpectrogramOptions & {
+      sampleRate?: number;
+      nMels?: number;
+      fMin?: number;
+      fMax?: number;
+      /** Natural log of the mel energies */
+      log?: boolean;
+    };
+
+    /** [freq, frames] for a [time] signal, [batch, freq, frames] for [batch, time] */
+    declare function stft(signal: Signal, options?: SpectrogramOptions): Promise<Tensor<typeof types.float>>;
+
+    declare function melSpectrogram(signal: Signal, options?: MelOptions): Promise<Tensor<typeof types.float>>;
+
+    declare function mfcc(
+      signal: Signal,
+      options?: Omit<MelOptions, "log"> & { nMfcc?: number; topDb?: number }
+    ): Promise<Tensor<typeof types.float>>;
+
+    declare function resample(
+      signal: Signal,
+      origFreq: number,
+      newFreq: number,
+      options?: { lowpassFilterWidth?: number; rolloff?: number }
+    ): Promise<Tensor<typeof types.float>>;
+
+    /** Frames are never centered, the overlap between chunks is carried to the next push */
+    declare class MelStream {
+      constructor(options?: Omit<MelOptions, "center">);
+
+      /** Resolves with the [nMels, frames] completed by this chunk, frames may be 0 */
+      push(chunk: Signal): Promise<Tensor<typeof types.float>>;
+
+      reset(): void;
+
+      /** Samples buffered for the next frame */
+      pending: number;
+    }
+  }
+
+  namespace safetensors {
+    /** With mmap (the default) tensors share the file's pages copy on write and are read on first touch */
+    declare function load(
+      path: string,
+      options?: { mmap?: boolean; names?: string[] }
+    ): Promise<Record<string, Tensor>>;
+
+    declare function save(
+      path: string,
+      tensors: Record<string, Tensor>,
+      options?: { metadata?: Record<string, string> }
+    ): Promise<void>;
+  }
+
+  /** Arrays are read in place when possible: mapped files, or the given buffer, which must not be changed afterwards */
+  namespace numpy {
+    /** .npy resolves to a Tensor, .npz to an object keyed by array name */
+    declare function load(
+      source: string | Uint8Array,
+      options?: { mmap?: boolean }
+    ): Promise<Tensor | Record<string, Tensor>>;
+
+    /** A Tensor is written as .npy, an object of tensors as .npz */
+    declare function save(
+      path: string,
+      tensors: Tensor | Record<string, Tensor>,
+      options?: { compress?: boolean }
+    ): Promise<void>;
+  }
+
+  namespace serialization {
+    /** Object mode on the writable side: write tensors, read Buffers */
+    declare class TensorStreamWriter extends import("stream").Transform {
+      constructor(options?: SerializeOptions);
+    }
+
+    /**
+     * Object mode on the readable side: write Buffers, read tensors. A frame longer than maxFrameBytes
+     * (default buffer.constants.MAX_LENGTH) errors the stream as soon as its header arrives
+     */
+    declare class TensorStreamReader extends import("stream").Transform {
+      constructor(options?: { maxFrameBytes?: number });
+    }
+  }
+
+  /** POSIX shared memory, segments outlive the processes using them until unlinked */
+  namespace shm {
+    /** Zero filled, throws if the name already exists */
+    declare function create<T extends TensorTypes = typeof types.float>(
+      name: string,
+      shape: number[],
+      dtype?: T
+    ): Tensor<T>;
+
+    /**
+     * Waits up to timeout ms (default 10000) for the creator. Throws and removes the segment if its creator
+     * exited before filling it.
+     * With readOnly the tensor is a view of a read only mapping, not a copy: any in-place op on it or on a
+     * view of it (add_, copy_, set_data, ...) crashes the process with SIGSEGV. Out of place ops are fine,
+     * clone() it for a private writable copy
+     */
+    declare function open(
+      name: string,
+      options?: { readOnly?: boolean; timeout?: number }
+    ): Tensor;
+
+    /** Removes the name, mappings already open stay valid */
+    declare function unlink(name: string): void;
+  }
+
   namespace nn {
     namespace functional {
       declare function interpolate<T extends TensorTypes>(
@@ -250,22 +675,285 @@ declare namespace torch {
   }
 
   namespace jit {
+    type SamplingOptions = {
+      /** Defaults to 1 once sampling is given, without sampling decoding is greedy */
+      temperature?: number;
+      topK?: number;
+      topP?: number;
+      seed?: number;
+    };
+
+    type GenerateOptions = {
+      maxNewTokens?: number;
+      eosTokenId?: number | number[];
+      /** Written after a sequence has finished, defaults to the first eos token */
+      padTokenId?: number;
+      sampling?: SamplingOptions;
+      /**
+       * Method called as (inputIds, pastKeyValues | None) returning (logits, pastKeyValues).
+       * Without it forward is rerun on the whole sequence every step
+       */
+      pastKeyValuesMethod?: string;
+      /** Called with the new token of every sequence after each step, generate settles after the last call */
+      onToken?: (tokens: number[]) => void;
+      /** Stops after the current step, resolving with the tokens generated so far */
+      signal?: AbortSignal;
+    };
+
     declare class Module<OutputType = Tensor> {
       forward: (...args: Tensor[]) => Promise<OutputType>;
+
+      /** Resolves with the prompt followed by the generated tokens, [batch, seq] */
+      generate: (
+        inputIds: Tensor,
+        options?: GenerateOptions
+      ) => Promise<Tensor<typeof types.long>>;
+
+      /** Breaking out of the loop stops the generation */
+      generateStream: (
+        inputIds: Tensor,
+        options?: Omit<GenerateOptions, "onToken">
+      ) => AsyncIterable<number[]>;
+
+      /** A handle to post to other worker_threads, the weights stay shared as long as this Module is alive */
+      share: () => SharedModuleHandle;
+
+      /**
+       * CPU bfloat16 autocast for forward. Stays off, returning false, on CPUs without AVX512-BF16 or AMX
+       * unless forced. The first forward that fails under autocast is rerun once in float32, and autocast is
+       * switched off for the module if that succeeds. Later failures are reported as they are
+       */
+      setAutocast: (
+        mode: "bf16" | "none",
+        options?: { castOutputs?: boolean; force?: boolean }
+      ) => boolean;
+
+      /**
+       * Restrides 4d weights in place, pair with channelsLast inputs so convolutions skip layout conversions.
+       * Throws for modules loaded with quantize or sharedWeights (and their share() copies)
+       */
+      toMemoryFormat: (format: MemoryFormats) => Module<OutputType>;
+
+      /** Set for modules quantized by jit.load */
+      quantization: QuantizationReport | null;
+
+      /** Swaps parameters and buffers in place, tensors already matching device and dtype are used without a copy */
+      loadStateDict: (
+        stateDict: Record<string, Tensor>,
+        options?: { strict?: boolean }
+      ) => { missingKeys: string[]; unexpectedKeys: string[] };
     }
 
+    type SharedModuleHandle = { sharedModuleId: number };
+
+    /** A Module backed by the same native weights as the one that created the handle */
+    declare function fromShared<OutputType = Tensor>(
+      handle: SharedModuleHandle
+    ): Module<OutputType>;
+
+    type LoadOptions = {
+      /**
+       * Shared memory name for the parameters and buffers. The first process fills it, others map it
+       * read only, so the weights must not be modified in place. A segment left unfilled by a crashed
+       * process, or holding different weights (e.g. from a previous deploy), is removed and recreated.
+       * POSIX only
+       */
+      sharedWeights?: string;
+      /**
+       * Converts floating point parameters and buffers once, e.g. "bfloat16" together with setAutocast("bf16").
+       * Integer buffers are left as they are, non floating point dtypes are rejected
+       */
+      dtype?: TensorTypes;
+      /**
+       * Freezes the module and runs every Linear with int8 weights through fbgemm/qnnpack dynamic kernels.
+       * Only forward is kept, not combinable with sharedWeights
+       */
+      quantize?: "dynamic-int8" | "none";
+    };
+
+    type QuantizationReport = {
+      mode: "dynamic-int8";
+      engine: "fbgemm" | "qnnpack";
+      linearLayers: number;
+      bytesBefore: number;
+      bytesAfter: number;
+    };
+
     declare function load<OutputType = Tensor>(
-      path: string
+      path: string,
+      options?: LoadOptions
     ): Promise<Module<OutputType>>;
   }
 
   namespace vision {
     namespace ops {
+      type LetterboxMeta = {
+        scale: number;
+        padLeft: number;
+        padTop: number;
+        width: number;
+        height: number;
+      };
+
       declare function nms<B extends TensorTypes, S extends TensorTypes>(
         boxes: Tensor<B>,
         scores: Tensor<S>,
         iouThreshold: number
       ): Tensor<B>;
+
+      declare function letterbox<T extends TensorTypes>(
+        image: Tensor<T>,
+        options?: {
+          size?: number | [number, number];
+          fill?: number;
+          stride?: number;
+          scaleUp?: boolean;
+        }
+      ): Promise<{ tensor: Tensor<T>; meta: LetterboxMeta }>;
+
+      declare function batchedNms<B extends TensorTypes, S extends TensorTypes>(
+        boxes: Tensor<B>,
+        scores: Tensor<S>,
+        classIdxs?: Tensor | null,
+        batchIdxs?: Tensor | null,
+        options?: {
+          iouThreshold?: number;
+          scoreThreshold?: number;
+          maxPerImage?: number;
+          maxTotal?: number;
+          /** Highest scoring candidates kept per image before NMS runs */
+          maxCandidates?: number;
+          numImages?: number;
+        }
+      ): Promise<Tensor<typeof types.long>[]>;
+
+      type Detections = {
+        boxes: Tensor<typeof types.float>;
+        scores: Tensor<typeof types.float>;
+        classes: Tensor<typeof types.long>;
+      };
+
+      type DecodeDetectionsOptions = {
+        format?: 'yolov5' | 'yolov8' | 'xyxy';
+        confThreshold?: number;
+        iouThreshold?: number;
+        maxCandidates?: number;
+        maxDetections?: number;
+        classAgnostic?: boolean;
+        letterboxMeta?: LetterboxMeta;
+      };
+
+      declare function decodeDetections(
+        output: Tensor,
+        options?: DecodeDetectionsOptions
+      ): Promise<Detections[]>;
+
+      type BoxFormats = 'xyxy' | 'xywh' | 'cxcywh';
+
+      /** Either [K, 5] rois of (batchIndex, x1, y1, x2, y2) or one [Ki, 4] box tensor per image */
+      type Rois = Tensor | Tensor[];
+
+      declare function roiAlign<T extends TensorTypes>(
+        input: Tensor<T>,
+        rois: Rois,
+        options?: {
+          outputSize?: number | [number, number];
+          spatialScale?: number;
+          samplingRatio?: number;
+          aligned?: boolean;
+        }
+      ): Promise<Tensor<T>>;
+
+      declare function roiPool<T extends TensorTypes>(
+        input: Tensor<T>,
+        rois: Rois,
+        options?: {
+          outputSize?: number | [number, number];
+          spatialScale?: number;
+        }
+      ): Promise<Tensor<T>>;
+
+      declare function boxIou<T extends TensorTypes>(
+        boxes1: Tensor<T>,
+        boxes2: Tensor<T>
+      ): Promise<Tensor<T>>;
+
+      declare function boxConvert<T extends TensorTypes>(
+        boxes: Tensor<T>,
+        inFormat: BoxFormats,
+        outFormat: BoxFormats
+      ): Promise<Tensor<T>>;
+
+      declare function clipBoxes<T extends TensorTypes>(
+        boxes: Tensor<T>,
+        size: [number, number]
+      ): Promise<Tensor<T>>;
+
+      declare function removeSmallBoxes<T extends TensorTypes>(
+        boxes: Tensor<T>,
+        minSize: number
+      ): Promise<Tensor<typeof types.long>>;
+
+      /**
+       * Resolves with a PNG file, or with raw HWC bytes (RGB when a palette is given, class indices otherwise)
+       */
+      declare function segmentationToMask(
+        logits: Tensor,
+        options?: {
+          size?: number | [number, number];
+          palette?: [number, number, number][] | number[] | Uint8Array;
+          format?: 'png' | 'raw';
+        }
+      ): Promise<Buffer>;
+    }
+
+    namespace tiling {
+      declare function run(
+        module: jit.Module,
+        image: Tensor,
+        options?: ops.DecodeDetectionsOptions & {
+          tileSize?: number | [number, number];
+          overlap?: number;
+          batchSize?: number;
+          fill?: number;
+          normalize?: boolean;
+        }
+      ): Promise<ops.Detections>;
+    }
+
+    /**
+     * Every transform works on a CHW image or a whole NCHW batch, each sample draws
+     * from its own generator derived from `seed` so results are reproducible
+     */
+    namespace transforms {
+      type Range = number | [number, number];
+      type Seeded = { seed?: number };
+
+      type RandomResizedCropOptions = { size?: number | [number, number]; scale?: Range; ratio?: Range };
+      type HorizontalFlipOptions = { p?: number };
+      type ColorJitterOptions = { brightness?: number; contrast?: number; saturation?: number };
+      type AffineOptions = { degrees?: number; translate?: number; scale?: Range; shear?: number };
+      type GaussianBlurOptions = { kernelSize?: number; sigma?: Range };
+
+      type Transform =
+        | ({ type: 'randomResizedCrop' } & RandomResizedCropOptions)
+        | ({ type: 'horizontalFlip' } & HorizontalFlipOptions)
+        | ({ type: 'colorJitter' } & ColorJitterOptions)
+        | ({ type: 'affine' } & AffineOptions)
+        | ({ type: 'gaussianBlur' } & GaussianBlurOptions);
+
+      declare function randomResizedCrop<T extends TensorTypes>(batch: Tensor<T>, options?: RandomResizedCropOptions & Seeded): Promise<Tensor<T>>;
+
+      declare function horizontalFlip<T extends TensorTypes>(batch: Tensor<T>, options?: HorizontalFlipOptions & Seeded): Promise<Tensor<T>>;
+
+      declare function colorJitter<T extends TensorTypes>(batch: Tensor<T>, options?: ColorJitterOptions & Seeded): Promise<Tensor<T>>;
+
+      declare function affine<T extends TensorTypes>(batch: Tensor<T>, options?: AffineOptions & Seeded): Promise<Tensor<T>>;
+
+      declare function gaussianBlur<T extends TensorTypes>(batch: Tensor<T>, options?: GaussianBlurOptions & Seeded): Promise<Tensor<T>>;
+
+      /** Runs a whole augmentation pipeline in one native task */
+      declare function apply<T extends TensorTypes>(batch: Tensor<T>, transforms: Transform[], options?: Seeded): Promise<Tensor<T>>;
     }
 
     namespace io {
@@ -297,6 +985,47 @@ declare namespace torch {
 
   }
 
+  namespace data {
+    type ImageBatch = {
+      images: Tensor;
+      /** Index into `classes`, -1 for images directly inside the root */
+      labels: Tensor<typeof types.long>;
+      paths: string[];
+    };
+
+    declare class ImageFolderLoader implements AsyncIterable<ImageBatch> {
+      constructor(options: {
+        root: string;
+        batchSize?: number;
+        shuffle?: boolean;
+        seed?: number;
+        numWorkers?: number;
+        prefetch?: number;
+        transform?: {
+          size?: number | [number, number];
+          letterbox?: boolean;
+          dtype?: typeof types.float | typeof types.uint8;
+          mean?: number[];
+          std?: number[];
+          /** channelsLast batches keep their [N, C, H, W] shape with NHWC strides */
+          memoryFormat?: "contiguous" | "channelsLast";
+        };
+      });
+
+      /** Empty until the directory scan has finished */
+      classes: string[];
+
+      size: number;
+
+      /** Batches come back in order whatever numWorkers is, resolves with null once every image has been returned */
+      next: () => Promise<ImageBatch | null>;
+
+      close: () => void;
+
+      [Symbol.asyncIterator](): AsyncIterator<ImageBatch>;
+    }
+  }
+
   namespace cuda {
     declare function isAvailable(): boolean;
     declare function deviceCount(): number;
@@ -1,24 +1,8 @@
 "use strict";
 const torch = require("bindings")("nodeml_torch");
 const types = torch.types
-
-function makeTypedArray(dtype,data) {
-  switch (dtype) {
-    case types.int32:
-      return new Int32Array(data);
-    case types.double:
-      return new Float64Array(data);
-    case types.float:
-      return new Float32Array(data);
-
-    case types.uint8:
-      return new Uint8Array(data);
-    case types.long:
-      return new BigInt64Array(data);
-    default:
-      throw new Error("No typed array for type " + dtype)
-  }
-}
+const { Transform } = require("stream");
+const { constants: bufferConstants } = require("buffer");
 
 torch.Tensor.prototype[Symbol.iterator] = function * () {
   const shape = this.shape;
@@ -27,65 +11,117 @@ torch.Tensor.prototype[Symbol.iterator] = function * () {
   }
 }
 
-// torch.Tensor.prototype.toMultiArray = function () {
-//   const arr = Array.from(this.toArray());
-//   const shape = this.shape;
-//   const result = [];
-//   const totalElements = shape.reduce((acc, cur) => acc * cur, 1);
+torch.data.ImageFolderLoader.prototype[Symbol.asyncIterator] = async function * () {
+  for (let batch = await this.next(); batch !== null; batch = await this.next()) {
+    yield batch
+  }
+}
 
-//   for (let i = 0; i < totalElements; i++) {
-//     let position = result;
-//     let index = i;
+// generate settles only after its last onToken call, so every token is queued before done is set.
+// Leaving the loop early aborts the generation
+torch.jit.Module.prototype.generateStream = async function * (inputIds, options = {}) {
+  const pending = [];
+  let wake = null;
+  let done = false;
+  let error = null;
 
-//     for (let j = shape.length - 1; j >= 0; j--) {
-//       const currentShape = shape[j];
-//       const currentIndex = index % currentShape;
-//       index = Math.floor(index / currentShape);
+  const controller = new AbortController();
+  if (options.signal) {
+    if (options.signal.aborted) controller.abort();
+    else options.signal.addEventListener("abort", () => controller.abort(), { once: true });
+  }
 
-//       if (position[currentIndex] === undefined) {
-//         position[currentIndex] = j === 0 ? arr[i] : [];
-//       }
+  this.generate(inputIds, {
+    ...options,
+    signal: controller.signal,
+    onToken: (tokens) => {
+      pending.push(tokens);
+      if (wake) wake();
+    },
+  }).catch((e) => { error = e; }).finally(() => {
+    done = true;
+    if (wake) wake();
+  });
 
-//       position = position[currentIndex];
-//     }
-//   }
+  try {
+    while (true) {
+      if (pending.length > 0) {
+        yield pending.shift();
+      } else if (error) {
+        throw error;
+      } else if (done) {
+        return;
+      } else {
+        await new Promise((resolve) => { wake = resolve; });
+        wake = null;
+      }
+    }
+  } finally {
+    controller.abort();
+  }
+}
 
-//   return result;
-// };
+// Writable side takes tensors, readable side emits their serialized frames
+class TensorStreamWriter extends Transform {
+  constructor(options = {}) {
+    super({ writableObjectMode: true });
+    this.serializeOptions = options;
+  }
 
-function flattenArray(arr) {
-  const shape = [arr.length]
-  while (arr.length > 0 && Array.isArray(arr[0])) {
-    shape.push(arr[0].length)
-    // Forcing Array<any> is required to make TS happy; otherwise, TS2349
-    arr = arr.reduce((acc, val) => acc.concat(val), [])
+  _transform(tensor, _encoding, callback) {
+    try {
+      callback(null, tensor.serialize(this.serializeOptions));
+    } catch (e) {
+      callback(e);
+    }
+  }
+}
+
+// Reassembles frames split across chunks, uncompressed tensors view the chunk they arrived in.
+// Frame lengths are checked before waiting for more bytes, so a corrupt header fails instead of buffering forever
+class TensorStreamReader extends Transform {
+  constructor(options = {}) {
+    super({ readableObjectMode: true });
+    this.pending = Buffer.alloc(0);
+    this.maxFrameBytes = options.maxFrameBytes !== undefined ? options.maxFrameBytes : bufferConstants.MAX_LENGTH;
+  }
 
-    // Running assert in every step to make sure that shape is regular
-    const numel = shape.reduce((acc, cur) => acc * cur)
-    assert.strictEqual(arr.length, numel)
+  _transform(chunk, _encoding, callback) {
+    try {
+      this.pending = this.pending.length > 0 ? Buffer.concat([this.pending, chunk]) : chunk;
+      let length;
+      while ((length = torch.Tensor.frameLength(this.pending)) !== null) {
+        if (length < 0 || length > this.maxFrameBytes) {
+          throw new Error(`Tensor frame of ${length} bytes exceeds maxFrameBytes ${this.maxFrameBytes}`);
+        }
+        if (this.pending.length < length) {
+          break;
+        }
+        this.push(torch.Tensor.deserialize(this.pending.subarray(0, length)));
+        this.pending = this.pending.subarray(length);
+      }
+      callback();
+    } catch (e) {
+      callback(e);
+    }
   }
-  return {
-    data: arr,
-    shape
+
+  _flush(callback) {
+    callback(this.pending.length > 0 ? new Error("Stream ended inside a tensor frame") : null);
   }
 }
 
+torch.serialization = { TensorStreamWriter, TensorStreamReader };
 
-function tensor(data, shape) {
+// Nested arrays are walked natively in one pass, see scripts/bench-nested.js for the JS baseline
+function tensor(data, shape, dtype) {
   if (ArrayBuffer.isView(data)) {
-    return torch.Tensor.fromTypedArray(data, shape || [data.length]);
-  }
-  else {
-    const payload = flattenArray(data)
-    const tensorShape = shape || payload.shape
-    if(typeof payload.data[0] == 'boolean'){
-      return torch.Tensor.fromTypedArray(makeTypedArray('int32',payload.data.map(c => c ? 1 : 0)),tensorShape).type(types.bool)
-    }
-    else
-    {
-      return torch.Tensor.fromTypedArray(makeTypedArray('float',payload.data),tensorShape)
-    }
+    return dtype
+      ? torch.Tensor.fromTypedArray(data, shape || [data.length], dtype)
+      : torch.Tensor.fromTypedArray(data, shape || [data.length]);
   }
+  const result = torch.Tensor.fromNestedArray(data, dtype);
+  return shape ? result.reshape(shape) : result;
 }
 
 module.exports = { ...torch, tensor };
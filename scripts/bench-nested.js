@@ -0,0 +1,70 @@
+// Compares the native nested array conversions against the JS versions they replaced.
+// node scripts/bench-nested.js
+const torch = require("../lib");
+
+// What torch.tensor did before fromNestedArray
+function jsFromNested(data) {
+  const shape = [data.length];
+  let flat = data;
+  while (flat.length > 0 && Array.isArray(flat[0])) {
+    shape.push(flat[0].length);
+    flat = flat.reduce((acc, val) => acc.concat(val), []);
+  }
+  return torch.Tensor.fromTypedArray(new Float32Array(flat), shape);
+}
+
+// The toMultiArray that was left commented out in lib/index.js
+function jsToNested(tensor) {
+  const arr = Array.from(tensor.toArray());
+  const shape = tensor.shape;
+  const result = [];
+  const totalElements = shape.reduce((acc, cur) => acc * cur, 1);
+
+  for (let i = 0; i < totalElements; i++) {
+    let position = result;
+    let index = i;
+
+    for (let j = shape.length - 1; j >= 0; j--) {
+      const currentIndex = index % shape[j];
+      index = Math.floor(index / shape[j]);
+
+      if (position[currentIndex] === undefined) {
+        position[currentIndex] = j === 0 ? arr[i] : [];
+      }
+
+      position = position[currentIndex];
+    }
+  }
+
+  return result;
+}
+
+function time(fn, iterations) {
+  for (let i = 0; i < Math.min(iterations, 10); i++) fn();
+  const start = process.hrtime.bigint();
+  for (let i = 0; i < iterations; i++) fn();
+  return Number(process.hrtime.bigint() - start) / 1e3 / iterations;
+}
+
+const shapes = [[4], [8, 16], [64, 128], [16, 32, 32], [256, 512]];
+
+for (const shape of shapes) {
+  const numel = shape.reduce((acc, cur) => acc * cur, 1);
+  const iterations = Math.max(5, Math.floor(2e6 / numel));
+  const source = torch.rand(shape);
+  const nested = source.toNestedArray();
+
+  const results = {
+    "tensor js": time(() => jsFromNested(nested), iterations),
+    "tensor native": time(() => torch.tensor(nested), iterations),
+    "toNestedArray js": time(() => jsToNested(source), iterations),
+    "toNestedArray native": time(() => source.toNestedArray(), iterations),
+  };
+
+  console.log(
+    `[${shape.join(", ")}] ` +
+      Object.entries(results)
+        .map(([name, us]) => `${name}: ${us.toFixed(2)}us`)
+        .join("  ")
+  );
+}
@@ -0,0 +1,17 @@
+#include <addon/AddonData.hpp>
+#include <addon/SharedTensor.hpp>
+
+namespace nodeml_torch
+{
+    AddonData *AddonData::Create(Napi::Env env)
+    {
+        auto data = new AddonData();
+        env.SetInstanceData<AddonData>(data);
+        return data;
+    }
+
+    AddonData *AddonData::Get(Napi::Env env)
+    {
+        return env.GetInstanceData<AddonData>();
+    }
+}
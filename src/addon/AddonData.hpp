@@ -0,0 +1,27 @@
+#pragma once
+
+#include <napi.h>
+
+#include <memory>
+
+namespace nodeml_torch
+{
+    struct ReleaseQueue;
+
+    // Class constructors of one Node environment, the main thread and every worker_thread get their own
+    struct AddonData
+    {
+        Napi::FunctionReference tensorConstructor;
+        Napi::FunctionReference generatorConstructor;
+        Napi::FunctionReference jitModuleConstructor;
+        Napi::FunctionReference flatIndexConstructor;
+        Napi::FunctionReference ivfIndexConstructor;
+        // Created on first use by shared tensors
+        std::shared_ptr<ReleaseQueue> releaseQueue;
+
+        // Must run before any class is registered, Node deletes the data when the environment shuts down
+        static AddonData *Create(Napi::Env env);
+
+        static AddonData *Get(Napi::Env env);
+    };
+}
@@ -0,0 +1,79 @@
+#include <addon/Generator.hpp>
+#include <addon/AddonData.hpp>
+#include <addon/sampling.hpp>
+
+#include <mutex>
+
+namespace nodeml_torch
+{
+    Napi::Object Generator::Init(Napi::Env env, Napi::Object exports)
+    {
+        auto func = DefineClass(env, "Generator",
+                                {
+                                    Generator::InstanceMethod("manualSeed", &Generator::ManualSeed),
+                                    Generator::InstanceMethod("seed", &Generator::Seed),
+                                    Generator::InstanceMethod("initialSeed", &Generator::InitialSeed),
+                                });
+
+        AddonData::Get(env)->generatorConstructor = Napi::Persistent(func);
+        exports.Set("Generator", func);
+        return exports;
+    }
+
+    bool Generator::IsInstance(const Napi::Value &value)
+    {
+        return value.IsObject() && value.ToObject().InstanceOf(AddonData::Get(value.Env())->generatorConstructor.Value());
+    }
+
+    c10::optional<at::Generator> Generator::FromValue(const Napi::Value &value)
+    {
+        if (!IsInstance(value))
+        {
+            return c10::nullopt;
+        }
+
+        return Napi::ObjectWrap<Generator>::Unwrap(value.ToObject())->generator;
+    }
+
+    Generator::Generator(const Napi::CallbackInfo &info) : ObjectWrap(info)
+    {
+        generator = sampling::makeGenerator(0);
+
+        std::lock_guard<std::mutex> lock(generator.mutex());
+        if (info.Length() > 0 && info[0].IsNumber())
+        {
+            generator.set_current_seed(uint64_t(info[0].ToNumber().Int64Value()));
+        }
+        else
+        {
+            generator.seed();
+        }
+    }
+
+    Napi::Value Generator::ManualSeed(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            std::lock_guard<std::mutex> lock(generator.mutex());
+            generator.set_current_seed(uint64_t(info[0].ToNumber().Int64Value()));
+            return info.This();
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Generator::Seed(const Napi::CallbackInfo &info)
+    {
+        std::lock_guard<std::mutex> lock(generator.mutex());
+        return Napi::Number::New(info.Env(), double(generator.seed()));
+    }
+
+    Napi::Value Generator::InitialSeed(const Napi::CallbackInfo &info)
+    {
+        std::lock_guard<std::mutex> lock(generator.mutex());
+        return Napi::Number::New(info.Env(), double(generator.current_seed()));
+    }
+}
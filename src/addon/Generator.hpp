@@ -0,0 +1,33 @@
+#pragma once
+
+#include <napi.h>
+
+#include <torch/torch.h>
+
+namespace nodeml_torch
+{
+
+    // Seeded CPU random state that sampling ops accept in place of the global generator
+    class Generator : public Napi::ObjectWrap<Generator>
+    {
+
+    public:
+        at::Generator generator;
+
+        static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+        static bool IsInstance(const Napi::Value &value);
+
+        // The generator wrapped by value, or none when value is not a Generator
+        static c10::optional<at::Generator> FromValue(const Napi::Value &value);
+
+        Generator(const Napi::CallbackInfo &info);
+
+        Napi::Value ManualSeed(const Napi::CallbackInfo &info);
+
+        Napi::Value Seed(const Napi::CallbackInfo &info);
+
+        Napi::Value InitialSeed(const Napi::CallbackInfo &info);
+    };
+
+}
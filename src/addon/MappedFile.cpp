@@ -0,0 +1,76 @@
+#include <addon/MappedFile.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nodeml_torch
+{
+    MappedFile::~MappedFile()
+    {
+#ifndef _WIN32
+        if (mapped)
+        {
+            munmap(base, length);
+        }
+#endif
+    }
+
+    std::shared_ptr<MappedFile> MappedFile::Open(const std::string &path)
+    {
+        auto file = std::shared_ptr<MappedFile>(new MappedFile());
+
+#ifndef _WIN32
+        auto fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Could not open " + path + ": " + std::strerror(errno));
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0)
+        {
+            auto message = std::string(std::strerror(errno));
+            ::close(fd);
+            throw std::runtime_error("Could not stat " + path + ": " + message);
+        }
+
+        file->length = size_t(info.st_size);
+        if (file->length > 0)
+        {
+            auto base = mmap(nullptr, file->length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (base == MAP_FAILED)
+            {
+                auto message = std::string(std::strerror(errno));
+                ::close(fd);
+                throw std::runtime_error("Could not map " + path + ": " + message);
+            }
+            file->base = static_cast<uint8_t *>(base);
+            file->mapped = true;
+        }
+        ::close(fd);
+#else
+        std::ifstream stream(path, std::ios::binary | std::ios::ate);
+        if (!stream)
+        {
+            throw std::runtime_error("Could not open " + path);
+        }
+
+        file->contents.resize(size_t(stream.tellg()));
+        stream.seekg(0);
+        stream.read(reinterpret_cast<char *>(file->contents.data()), file->contents.size());
+        file->base = file->contents.data();
+        file->length = file->contents.size();
+#endif
+
+        return file;
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nodeml_torch
+{
+    // A read only view of a whole file. Pages are mapped copy on write where mmap exists, so tensors built
+    // on top share the page cache and may still be modified in place. Elsewhere the file is read into memory
+    class MappedFile
+    {
+    public:
+        ~MappedFile();
+
+        static std::shared_ptr<MappedFile> Open(const std::string &path);
+
+        uint8_t *data() const { return base; }
+
+        size_t size() const { return length; }
+
+    private:
+        uint8_t *base = nullptr;
+        size_t length = 0;
+        bool mapped = false;
+        std::vector<uint8_t> contents;
+
+        MappedFile() = default;
+    };
+}
@@ -0,0 +1,344 @@
+#include <addon/Serialization.hpp>
+#include <addon/SharedTensor.hpp>
+
+#include <c10/util/safe_numerics.h>
+#include <cstring>
+#include <limits>
+#include <zlib.h>
+
+namespace nodeml_torch
+{
+    // "NTW1" read as little endian
+    static const uint32_t wireMagic = 0x3157544e;
+    static const size_t fixedHeaderBytes = 16;
+
+    struct WireHeader
+    {
+        torch::ScalarType dtype = torch::kFloat;
+        WireQuantization quantization = WireQuantization::None;
+        WireCompression compression = WireCompression::None;
+        std::vector<int64_t> shape;
+        uint64_t payloadBytes = 0;
+        float scale = 1;
+        size_t headerBytes = 0;
+    };
+
+    // Fixed codes so frames stay readable across libtorch versions, whose ScalarType numbering is internal
+    static const std::vector<std::pair<torch::ScalarType, uint8_t>> wireDtypeCodes = {
+        {torch::kFloat32, 1},
+        {torch::kFloat64, 2},
+        {torch::kFloat16, 3},
+        {torch::kBFloat16, 4},
+        {torch::kUInt8, 5},
+        {torch::kInt8, 6},
+        {torch::kInt16, 7},
+        {torch::kInt32, 8},
+        {torch::kInt64, 9},
+        {torch::kBool, 10},
+    };
+
+    static uint8_t dtypeToWire(torch::ScalarType dtype)
+    {
+        for (const auto &[type, code] : wireDtypeCodes)
+        {
+            if (type == dtype)
+            {
+                return code;
+            }
+        }
+        throw std::invalid_argument(std::string("Cannot serialize tensors of type ") + c10::toString(dtype));
+    }
+
+    static torch::ScalarType dtypeFromWire(uint8_t code)
+    {
+        for (const auto &[type, known] : wireDtypeCodes)
+        {
+            if (known == code)
+            {
+                return type;
+            }
+        }
+        throw std::runtime_error("Unsupported serialized tensor encoding");
+    }
+
+    static size_t headerBytesFor(size_t ndim, WireQuantization quantization)
+    {
+        auto bytes = fixedHeaderBytes + 8 * ndim + (quantization == WireQuantization::Int8 ? 4 : 0);
+        return (bytes + 7) / 8 * 8;
+    }
+
+    static void writeLE(uint8_t *out, uint64_t value, int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            out[i] = uint8_t(value >> (8 * i));
+        }
+    }
+
+    static uint64_t readLE(const uint8_t *bytes, int count)
+    {
+        uint64_t value = 0;
+        for (int i = count - 1; i >= 0; i--)
+        {
+            value = (value << 8) | bytes[i];
+        }
+        return value;
+    }
+
+    SerializeOptions serializeOptionsFromObject(const Napi::Object &obj)
+    {
+        SerializeOptions options;
+
+        if (obj.Has("compress"))
+        {
+            auto compress = obj.Get("compress").ToString().Utf8Value();
+            if (compress == "zlib")
+            {
+                options.compression = WireCompression::Zlib;
+            }
+            else if (compress != "none")
+            {
+                throw std::invalid_argument("compress must be 'none' or 'zlib'");
+            }
+        }
+
+        if (obj.Has("quantize"))
+        {
+            auto quantize = obj.Get("quantize").ToString().Utf8Value();
+            if (quantize == "fp16")
+            {
+                options.quantization = WireQuantization::Fp16;
+            }
+            else if (quantize == "int8")
+            {
+                options.quantization = WireQuantization::Int8;
+            }
+            else if (quantize != "none")
+            {
+                throw std::invalid_argument("quantize must be 'none', 'fp16' or 'int8'");
+            }
+        }
+
+        return options;
+    }
+
+    static WireHeader parseHeader(const uint8_t *data, size_t size)
+    {
+        if (size < fixedHeaderBytes || readLE(data, 4) != wireMagic)
+        {
+            throw std::runtime_error("Not a serialized tensor");
+        }
+
+        WireHeader header;
+        header.dtype = dtypeFromWire(data[4]);
+        header.quantization = WireQuantization(data[5]);
+        header.compression = WireCompression(data[6]);
+        auto ndim = size_t(data[7]);
+        header.payloadBytes = readLE(data + 8, 8);
+        header.headerBytes = headerBytesFor(ndim, header.quantization);
+
+        if (data[5] > uint8_t(WireQuantization::Int8) || data[6] > uint8_t(WireCompression::Zlib))
+        {
+            throw std::runtime_error("Unsupported serialized tensor encoding");
+        }
+
+        if (size < header.headerBytes)
+        {
+            throw std::runtime_error("Truncated serialized tensor header");
+        }
+
+        for (size_t i = 0; i < ndim; i++)
+        {
+            header.shape.push_back(int64_t(readLE(data + fixedHeaderBytes + 8 * i, 8)));
+            if (header.shape.back() < 0)
+            {
+                throw std::runtime_error("Invalid serialized tensor shape");
+            }
+        }
+
+        if (header.quantization == WireQuantization::Int8)
+        {
+            uint32_t bits = uint32_t(readLE(data + fixedHeaderBytes + 8 * ndim, 4));
+            std::memcpy(&header.scale, &bits, 4);
+        }
+
+        return header;
+    }
+
+    int64_t serializedFrameLength(const uint8_t *data, size_t size)
+    {
+        if (size < fixedHeaderBytes)
+        {
+            return -1;
+        }
+
+        if (readLE(data, 4) != wireMagic)
+        {
+            throw std::runtime_error("Not a serialized tensor");
+        }
+
+        // The payload size is untrusted, lengths that do not fit int64 would come back negative
+        uint64_t length = 0;
+        if (c10::add_overflows(uint64_t(headerBytesFor(data[7], WireQuantization(data[5]))), readLE(data + 8, 8), &length) ||
+            length > uint64_t(std::numeric_limits<int64_t>::max()))
+        {
+            throw std::runtime_error("Corrupt tensor frame length");
+        }
+
+        return int64_t(length);
+    }
+
+    Napi::Buffer<uint8_t> serializeTensor(Napi::Env env, const torch::Tensor &tensor, const SerializeOptions &options)
+    {
+        auto source = tensor.detach().cpu();
+        if (source.dim() > 255)
+        {
+            throw std::invalid_argument("Too many dimensions to serialize");
+        }
+        auto dtypeCode = dtypeToWire(source.scalar_type());
+
+        if (options.quantization != WireQuantization::None && !source.is_floating_point())
+        {
+            throw std::invalid_argument("quantize requires a floating point tensor");
+        }
+
+        torch::Tensor payload;
+        float scale = 1;
+        switch (options.quantization)
+        {
+        case WireQuantization::None:
+            payload = source.contiguous();
+            break;
+        case WireQuantization::Fp16:
+            payload = source.to(torch::kHalf).contiguous();
+            break;
+        case WireQuantization::Int8:
+        {
+            auto maxAbs = source.numel() > 0 ? source.abs().max().item<float>() : 0.0f;
+            scale = maxAbs > 0 ? maxAbs / 127 : 1;
+            payload = source.to(torch::kFloat).div(scale).round_().clamp_(-127, 127).to(torch::kChar).contiguous();
+            break;
+        }
+        }
+
+        auto raw = static_cast<const uint8_t *>(payload.data_ptr());
+        size_t rawBytes = payload.nbytes();
+
+        std::vector<uint8_t> compressed;
+        if (options.compression == WireCompression::Zlib)
+        {
+            auto bound = compressBound(uLong(rawBytes));
+            compressed.resize(bound);
+            if (compress2(compressed.data(), &bound, raw, uLong(rawBytes), Z_DEFAULT_COMPRESSION) != Z_OK)
+            {
+                throw std::runtime_error("zlib compression failed");
+            }
+            compressed.resize(bound);
+            raw = compressed.data();
+            rawBytes = compressed.size();
+        }
+
+        auto headerBytes = headerBytesFor(source.dim(), options.quantization);
+        auto buffer = Napi::Buffer<uint8_t>::New(env, headerBytes + rawBytes);
+        auto out = buffer.Data();
+        std::memset(out, 0, headerBytes);
+
+        writeLE(out, wireMagic, 4);
+        out[4] = dtypeCode;
+        out[5] = uint8_t(options.quantization);
+        out[6] = uint8_t(options.compression);
+        out[7] = uint8_t(source.dim());
+        writeLE(out + 8, rawBytes, 8);
+        for (int64_t i = 0; i < source.dim(); i++)
+        {
+            writeLE(out + fixedHeaderBytes + 8 * i, uint64_t(source.size(i)), 8);
+        }
+        if (options.quantization == WireQuantization::Int8)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &scale, 4);
+            writeLE(out + fixedHeaderBytes + 8 * source.dim(), bits, 4);
+        }
+
+        if (rawBytes > 0)
+        {
+            std::memcpy(out + headerBytes, raw, rawBytes);
+        }
+
+        return buffer;
+    }
+
+    torch::Tensor deserializeTensor(Napi::Env env, const Napi::TypedArray &bytes)
+    {
+        auto data = static_cast<const uint8_t *>(bytes.ArrayBuffer().Data()) + bytes.ByteOffset();
+        auto size = bytes.ByteLength();
+        auto header = parseHeader(data, size);
+
+        if (header.payloadBytes > size - header.headerBytes)
+        {
+            throw std::runtime_error("Truncated serialized tensor payload");
+        }
+
+        auto storedType = header.quantization == WireQuantization::Fp16   ? torch::kHalf
+                          : header.quantization == WireQuantization::Int8 ? torch::kChar
+                                                                          : header.dtype;
+        // Checked before anything is allocated, the shape of an untrusted frame can ask for any size
+        uint64_t numel = 0;
+        uint64_t storedBytes = 0;
+        if (c10::safe_multiplies_u64(header.shape, &numel) || c10::mul_overflows(numel, uint64_t(c10::elementSize(storedType)), &storedBytes))
+        {
+            throw std::runtime_error("Serialized tensor shape is too large");
+        }
+
+        auto payload = data + header.headerBytes;
+        torch::Tensor stored;
+
+        if (header.compression == WireCompression::Zlib)
+        {
+            // zlib cannot expand beyond about 1032:1, larger claims are corrupt or hostile
+            if (storedBytes / 1032 > header.payloadBytes + 1 || storedBytes > std::numeric_limits<uLongf>::max())
+            {
+                throw std::runtime_error("Corrupt compressed tensor payload");
+            }
+
+            stored = torch::empty(header.shape, torch::TensorOptions(storedType));
+            auto length = uLongf(storedBytes);
+            if (uncompress(static_cast<Bytef *>(stored.data_ptr()), &length, payload, uLong(header.payloadBytes)) != Z_OK || length != storedBytes)
+            {
+                throw std::runtime_error("Corrupt compressed tensor payload");
+            }
+        }
+        else
+        {
+            if (header.payloadBytes != storedBytes)
+            {
+                throw std::runtime_error("Serialized tensor payload does not match its shape");
+            }
+
+            if (reinterpret_cast<uintptr_t>(payload) % c10::elementSize(storedType) == 0)
+            {
+                auto queue = ReleaseQueue::ForEnv(env);
+                auto reference = new Napi::ObjectReference(Napi::Persistent(bytes.ToObject()));
+                stored = torch::from_blob(
+                    const_cast<uint8_t *>(payload), header.shape, [queue, reference](void *)
+                    { queue->Release(reference); },
+                    torch::TensorOptions(storedType));
+            }
+            else
+            {
+                stored = torch::empty(header.shape, torch::TensorOptions(storedType));
+                std::memcpy(stored.data_ptr(), payload, storedBytes);
+            }
+        }
+
+        switch (header.quantization)
+        {
+        case WireQuantization::Fp16:
+            return stored.to(header.dtype);
+        case WireQuantization::Int8:
+            return stored.to(torch::kFloat).mul_(header.scale).to(header.dtype);
+        default:
+            return stored;
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <napi.h>
+
+#include <torch/torch.h>
+
+namespace nodeml_torch
+{
+    enum class WireCompression
+    {
+        None,
+        Zlib
+    };
+
+    enum class WireQuantization
+    {
+        None,
+        Fp16,
+        // Symmetric per tensor, one float scale
+        Int8
+    };
+
+    struct SerializeOptions
+    {
+        WireCompression compression = WireCompression::None;
+        WireQuantization quantization = WireQuantization::None;
+    };
+
+    SerializeOptions serializeOptionsFromObject(const Napi::Object &obj);
+
+    // One self delimiting frame: a header padded to 8 bytes followed by the payload
+    Napi::Buffer<uint8_t> serializeTensor(Napi::Env env, const torch::Tensor &tensor, const SerializeOptions &options);
+
+    // Uncompressed, unquantized frames are viewed in place and keep the buffer alive
+    torch::Tensor deserializeTensor(Napi::Env env, const Napi::TypedArray &bytes);
+
+    // Total bytes of the frame starting at data, -1 while fewer bytes than the fixed header are available
+    int64_t serializedFrameLength(const uint8_t *data, size_t size);
+}
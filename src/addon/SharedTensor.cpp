@@ -0,0 +1,150 @@
+#include <addon/SharedTensor.hpp>
+#include <addon/AddonData.hpp>
+#include <addon/utils.hpp>
+#include <c10/util/safe_numerics.h>
+
+namespace nodeml_torch
+{
+    std::shared_ptr<ReleaseQueue> ReleaseQueue::ForEnv(Napi::Env env)
+    {
+        auto data = AddonData::Get(env);
+        if (data->releaseQueue)
+        {
+            return data->releaseQueue;
+        }
+
+        auto queue = std::make_shared<ReleaseQueue>();
+        queue->tsfn = Napi::ThreadSafeFunction::New(
+            env, Napi::Function(), "nodeml_torch.release", 0, 1,
+            [](Napi::Env, std::shared_ptr<ReleaseQueue> *finalizeData)
+            {
+                {
+                    std::lock_guard<std::mutex> lock((*finalizeData)->mutex);
+                    (*finalizeData)->closed = true;
+                }
+                delete finalizeData;
+            },
+            new std::shared_ptr<ReleaseQueue>(queue));
+
+        // Pending releases must not keep the process alive
+        queue->tsfn.Unref(env);
+
+        data->releaseQueue = queue;
+        return queue;
+    }
+
+    void ReleaseQueue::Release(Napi::ObjectReference *reference)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed)
+        {
+            return;
+        }
+
+        tsfn.NonBlockingCall(reference, [](Napi::Env env, Napi::Function, Napi::ObjectReference *reference)
+                             { delete reference; });
+    }
+
+    Napi::Object sharedDescriptor(Napi::Env env, const Napi::Object &buffer, const torch::Tensor &tensor)
+    {
+        auto descriptor = Napi::Object::New(env);
+        descriptor.Set("buffer", buffer);
+        descriptor.Set("dtype", utils::scalarTypeToString(tensor.scalar_type()));
+        descriptor.Set("shape", utils::vectorToNapiArray(env, tensor.sizes().vec()));
+        descriptor.Set("strides", utils::vectorToNapiArray(env, tensor.strides().vec()));
+        descriptor.Set("offset", Napi::Number::New(env, double(tensor.storage_offset())));
+        return descriptor;
+    }
+
+    static Napi::TypedArrayOf<uint8_t> bytesOf(Napi::Env env, const Napi::Value &buffer)
+    {
+        // N-API has no accessor for SharedArrayBuffer memory, a Uint8Array view exposes it
+        return env.Global().Get("Uint8Array").As<Napi::Function>().New({buffer}).As<Napi::TypedArrayOf<uint8_t>>();
+    }
+
+    torch::Tensor tensorFromSharedDescriptor(Napi::Env env, const Napi::Object &descriptor)
+    {
+        auto buffer = descriptor.Get("buffer");
+        if (!buffer.IsObject())
+        {
+            throw std::invalid_argument("Descriptor has no buffer");
+        }
+
+        auto dtype = utils::stringToScalarType(descriptor.Get("dtype").ToString().Utf8Value());
+        auto shape = utils::napiArrayToVector<int64_t>(descriptor.Get("shape").As<Napi::Array>());
+        std::vector<int64_t> strides(shape.size(), 1);
+        if (descriptor.Has("strides"))
+        {
+            strides = utils::napiArrayToVector<int64_t>(descriptor.Get("strides").As<Napi::Array>());
+        }
+        else
+        {
+            for (int64_t i = int64_t(shape.size()) - 2; i >= 0; i--)
+            {
+                if (shape[i + 1] < 0 || c10::mul_overflows(strides[i + 1], std::max<int64_t>(shape[i + 1], 1), &strides[i]))
+                {
+                    throw std::invalid_argument("Descriptor shape is too large");
+                }
+            }
+        }
+        auto offset = descriptor.Has("offset") ? descriptor.Get("offset").ToNumber().Int64Value() : 0;
+
+        if (strides.size() != shape.size() || offset < 0)
+        {
+            throw std::invalid_argument("Descriptor strides do not match its shape");
+        }
+
+        auto bytes = bytesOf(env, buffer);
+        auto itemSize = int64_t(c10::elementSize(dtype));
+
+        // Highest element the view can reach must lie inside the buffer, descriptors may come from another
+        // thread so every step is overflow checked
+        int64_t last = offset;
+        for (size_t i = 0; i < shape.size(); i++)
+        {
+            if (shape[i] < 0 || strides[i] < 0)
+            {
+                throw std::invalid_argument("Negative sizes and strides are not supported");
+            }
+
+            if (shape[i] == 0)
+            {
+                last = -1;
+                break;
+            }
+
+            int64_t reach = 0;
+            if (c10::mul_overflows(shape[i] - 1, strides[i], &reach) || c10::add_overflows(last, reach, &last))
+            {
+                throw std::invalid_argument("Descriptor shape does not fit in its buffer");
+            }
+        }
+
+        // Same as (last + 1) * itemSize > byteLength without the multiplication
+        if (last >= int64_t(bytes.ByteLength()) / itemSize)
+        {
+            throw std::invalid_argument("Descriptor shape does not fit in its buffer");
+        }
+
+        auto queue = ReleaseQueue::ForEnv(env);
+        auto reference = new Napi::ObjectReference(Napi::Persistent(buffer.ToObject()));
+
+        return torch::from_blob(
+            bytes.Data() + offset * itemSize, shape, strides, [queue, reference](void *)
+            { queue->Release(reference); },
+            torch::TensorOptions(dtype));
+    }
+
+    Napi::Object copyToShared(Napi::Env env, const torch::Tensor &tensor)
+    {
+        auto source = tensor.cpu().contiguous();
+        auto buffer = env.Global().Get("SharedArrayBuffer").As<Napi::Function>().New({Napi::Number::New(env, double(source.nbytes()))});
+
+        if (source.nbytes() > 0)
+        {
+            memcpy(bytesOf(env, buffer).Data(), source.data_ptr(), source.nbytes());
+        }
+
+        return sharedDescriptor(env, buffer, source);
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <napi.h>
+
+#include <memory>
+#include <mutex>
+#include <torch/torch.h>
+
+namespace nodeml_torch
+{
+    // Deletes JS references on their own thread for storage deleters that may run on any thread
+    struct ReleaseQueue
+    {
+        std::mutex mutex;
+        // Set once the environment is gone, references are then left to the VM teardown
+        bool closed = false;
+        Napi::ThreadSafeFunction tsfn;
+
+        static std::shared_ptr<ReleaseQueue> ForEnv(Napi::Env env);
+
+        void Release(Napi::ObjectReference *reference);
+    };
+
+    // { buffer: SharedArrayBuffer, dtype, shape, strides, offset } with strides and offset counted in elements
+    Napi::Object sharedDescriptor(Napi::Env env, const Napi::Object &buffer, const torch::Tensor &tensor);
+
+    // Views the SharedArrayBuffer in place, the tensor keeps the buffer alive in this environment
+    torch::Tensor tensorFromSharedDescriptor(Napi::Env env, const Napi::Object &descriptor);
+
+    // Copies tensor into a new SharedArrayBuffer once and returns its descriptor
+    Napi::Object copyToShared(Napi::Env env, const torch::Tensor &tensor);
+}
@@ -1,6 +1,15 @@
 #include <addon/Tensor.hpp>
+#include <addon/AddonData.hpp>
+#include <addon/FunctionWorker.hpp>
+#include <addon/Generator.hpp>
+#include <addon/Serialization.hpp>
+#include <addon/SharedTensor.hpp>
+#include <addon/sampling.hpp>
 #include <addon/types.hpp>
 #include <addon/utils.hpp>
+#include <algorithm>
+#include <c10/util/safe_numerics.h>
+#include <cmath>
 #include <exception>
 #include <iostream>
 
@@ -10,8 +19,6 @@ namespace nodeml_torch
     using namespace nodeml_torch::utils;
     using namespace nodeml_torch::types;
 
-    Napi::FunctionReference Tensor::constructor;
-
     template <typename T>
     Napi::Value tensorToArray(Napi::Env env, const torch::Tensor &torchTensor, std::function<Napi::Value(Napi::Env, T)> converter = nullptr)
     {
@@ -40,39 +47,149 @@ namespace nodeml_torch
         }
     }
 
-    template <typename T>
-    torch::Tensor arrayToTensor(
-        Napi::Env env, const Napi::TypedArray &data, const Napi::Array &shape_array)
+    std::vector<int64_t> shapeForArray(const Napi::TypedArray &data, const Napi::Array &shape_array)
     {
-        auto *data_ptr = data.As<Napi::TypedArrayOf<T>>().Data();
         auto shape = napiArrayToVector<std::int64_t>(shape_array);
-        torch::TensorOptions options(scalarType<T>());
-        auto torch_tensor = torch::empty(shape, options);
-        memcpy(torch_tensor.data_ptr<T>(), data_ptr, sizeof(T) * torch_tensor.numel());
-        return torch_tensor;
+        uint64_t numel = 0;
+        if (std::any_of(shape.begin(), shape.end(), [](int64_t size)
+                        { return size < 0; }) ||
+            c10::safe_multiplies_u64(shape, &numel) || numel != uint64_t(data.ElementLength()))
+        {
+            throw std::invalid_argument("Shape does not match the length of the array");
+        }
+        return shape;
     }
 
-    torch::Tensor typedArrayToTensor(
-        Napi::Env env, const Napi::TypedArray &data, const Napi::Array &shape)
+    // Element type of the array's memory, unsigned arrays without a libtorch type of the same width are read as their signed bits
+    static torch::ScalarType typedArrayStorageType(Napi::Env env, const Napi::TypedArray &data)
     {
-
-        auto arrayType = data.TypedArrayType();
-
-        switch (arrayType)
+        switch (data.TypedArrayType())
         {
         case napi_float32_array:
-            return arrayToTensor<float>(env, data, shape);
+            return torch::kFloat32;
         case napi_float64_array:
-            return arrayToTensor<double>(env, data, shape);
+            return torch::kFloat64;
         case napi_int32_array:
-            return arrayToTensor<int32_t>(env, data, shape);
+        case napi_uint32_array:
+            return torch::kInt32;
         case napi_uint8_array:
-            return arrayToTensor<uint8_t>(env, data, shape);
+        case napi_uint8_clamped_array:
+            return torch::kUInt8;
+        case napi_int8_array:
+            return torch::kInt8;
+        case napi_int16_array:
+        case napi_uint16_array:
+            return torch::kInt16;
+        case napi_bigint64_array:
+            return torch::kInt64;
         default:
             throw Napi::TypeError::New(env, "Unsupported type");
         }
     }
 
+    torch::ScalarType typedArrayScalarType(Napi::Env env, const Napi::TypedArray &data)
+    {
+        // libtorch has no unsigned 16 or 32 bit type, widening keeps every value exact
+        switch (data.TypedArrayType())
+        {
+        case napi_uint16_array:
+            return torch::kInt32;
+        case napi_uint32_array:
+            return torch::kInt64;
+        default:
+            return typedArrayStorageType(env, data);
+        }
+    }
+
+    void copyTypedArray(Napi::Env env, const Napi::TypedArray &data, torch::Tensor &dst)
+    {
+        if (dst.numel() != int64_t(data.ElementLength()))
+        {
+            throw std::invalid_argument("Shape does not match the length of the array");
+        }
+
+        auto arrayType = data.TypedArrayType();
+        auto source = torch::from_blob(static_cast<uint8_t *>(data.ArrayBuffer().Data()) + data.ByteOffset(), dst.sizes(),
+                                       torch::TensorOptions(typedArrayStorageType(env, data)));
+
+        // Half precision has no typed array in N-API, the raw bits travel in a Uint16Array
+        if (arrayType == napi_uint16_array && (dst.scalar_type() == torch::kHalf || dst.scalar_type() == torch::kBFloat16))
+        {
+            dst.view(torch::kInt16).copy_(source);
+        }
+        else if (arrayType == napi_uint16_array)
+        {
+            dst.copy_(source.to(torch::kInt32).bitwise_and_(0xFFFF));
+        }
+        else if (arrayType == napi_uint32_array)
+        {
+            dst.copy_(source.to(torch::kInt64).bitwise_and_(int64_t(0xFFFFFFFF)));
+        }
+        else
+        {
+            dst.copy_(source);
+        }
+    }
+
+    // Half precision has no typed array in N-API, the raw bits travel in a Uint16Array
+    static Napi::Value halfTensorToArray(Napi::Env env, const torch::Tensor &torchTensor)
+    {
+        Napi::EscapableHandleScope scope(env);
+        auto typed_array = Napi::TypedArrayOf<uint16_t>::New(env, torchTensor.numel());
+        memcpy(typed_array.Data(), torchTensor.data_ptr(), sizeof(uint16_t) * torchTensor.numel());
+        return scope.Escape(typed_array);
+    }
+
+    torch::Tensor typedArrayToTensor(
+        Napi::Env env, const Napi::TypedArray &data, const Napi::Array &shape)
+    {
+        auto tensor = torch::empty(shapeForArray(data, shape), torch::TensorOptions(typedArrayScalarType(env, data)));
+        copyTypedArray(env, data, tensor);
+        return tensor;
+    }
+
+    // Same int/float split as Number.isInteger without calling back into JS
+    static torch::Scalar napiNumberToScalar(const Napi::Value &value)
+    {
+        auto number = value.ToNumber().DoubleValue();
+
+        if (std::trunc(number) == number && std::abs(number) <= 9007199254740991.0)
+        {
+            return torch::Scalar(int64_t(number));
+        }
+
+        return torch::Scalar(number);
+    }
+
+    // Numbers become wrapped 0-dim tensors so they promote like scalars in the *_out kernels
+    static torch::Tensor napiValueToOperand(const Napi::Value &value)
+    {
+        if (value.IsNumber())
+        {
+            auto scalar = napiNumberToScalar(value);
+            auto wrapped = torch::scalar_tensor(scalar, scalar.isIntegral(false) ? torch::kLong : torch::kDouble);
+            wrapped.unsafeGetTensorImpl()->set_wrapped_number(true);
+            return wrapped;
+        }
+
+        return Tensor::FromObject(value)->torchTensor;
+    }
+
+    // The destination of an { out: tensor } option, or nullptr when the result should be a new tensor
+    static Tensor *outFromOptions(const Napi::CallbackInfo &info, size_t index)
+    {
+        if (info.Length() > index && info[index].IsObject() && !Tensor::IsInstance(info[index].ToObject()))
+        {
+            auto options = info[index].ToObject();
+            if (options.Has("out"))
+            {
+                return Tensor::FromObject(options.Get("out"));
+            }
+        }
+
+        return nullptr;
+    }
+
     Napi::Object Tensor::Init(Napi::Env env, Napi::Object exports)
     {
         auto func = DefineClass(env, "Tensor",
@@ -81,6 +198,13 @@ namespace nodeml_torch
                                  Tensor::InstanceMethod("reshape", &Tensor::Reshape),
                                  Tensor::InstanceMethod("toString", &Tensor::toString),
                                  Tensor::StaticMethod("fromTypedArray", &Tensor::FromTypedArray),
+                                 Tensor::StaticMethod("fromNestedArray", &Tensor::FromNestedArray),
+                                 Tensor::InstanceMethod("toNestedArray", &Tensor::ToNestedArray),
+                                 Tensor::StaticMethod("fromShared", &Tensor::FromShared),
+                                 Tensor::InstanceMethod("toShared", &Tensor::ToShared),
+                                 Tensor::InstanceMethod("serialize", &Tensor::Serialize),
+                                 Tensor::StaticMethod("deserialize", &Tensor::Deserialize),
+                                 Tensor::StaticMethod("frameLength", &Tensor::FrameLength),
                                  Tensor::InstanceMethod("type", &Tensor::Type),
                                  Tensor::InstanceMethod("transpose", &Tensor::Transpose),
                                  Tensor::InstanceAccessor("dtype", &Tensor::DType, nullptr),
@@ -90,6 +214,10 @@ namespace nodeml_torch
                                  Tensor::InstanceMethod("sub", &Tensor::Sub),
                                  Tensor::InstanceMethod("mul", &Tensor::Mul),
                                  Tensor::InstanceMethod("div", &Tensor::Div),
+                                 Tensor::InstanceMethod("add_", &Tensor::AddInPlace),
+                                 Tensor::InstanceMethod("sub_", &Tensor::SubInPlace),
+                                 Tensor::InstanceMethod("mul_", &Tensor::MulInPlace),
+                                 Tensor::InstanceMethod("div_", &Tensor::DivInPlace),
                                  Tensor::InstanceMethod("get", &Tensor::Index),
                                  Tensor::InstanceMethod("set", &Tensor::IndexPut),
                                  Tensor::InstanceMethod("clone", &Tensor::Clone),
@@ -100,19 +228,42 @@ namespace nodeml_torch
                                  Tensor::InstanceMethod("view", &Tensor::View),
                                  Tensor::InstanceMethod("any", &Tensor::Any),
                                  Tensor::InstanceMethod("max", &Tensor::Max),
+                                 Tensor::InstanceMethod("topk", &Tensor::Topk),
+                                 Tensor::InstanceMethod("topkAsync", &Tensor::TopkAsync),
+                                 Tensor::InstanceMethod("kthvalue", &Tensor::Kthvalue),
+                                 Tensor::InstanceMethod("kthvalueAsync", &Tensor::KthvalueAsync),
+                                 Tensor::InstanceMethod("softmax", &Tensor::Softmax),
+                                 Tensor::InstanceMethod("softmaxAsync", &Tensor::SoftmaxAsync),
+                                 Tensor::InstanceMethod("logSoftmax", &Tensor::LogSoftmax),
+                                 Tensor::InstanceMethod("logSoftmaxAsync", &Tensor::LogSoftmaxAsync),
+                                 Tensor::InstanceMethod("multinomial", &Tensor::Multinomial),
+                                 Tensor::InstanceMethod("multinomialAsync", &Tensor::MultinomialAsync),
+                                 Tensor::InstanceMethod("sampleTopP", &Tensor::SampleTopP),
+                                 Tensor::InstanceMethod("sampleTopPAsync", &Tensor::SampleTopPAsync),
                                  Tensor::InstanceMethod("clamp", &Tensor::Clamp),
-                                 Tensor::InstanceMethod("sigmoid", &Tensor::Sigmoid), Tensor::InstanceMethod("cpu", &Tensor::Cpu),
-                                 Tensor::InstanceMethod("cuda", &Tensor::Cuda), Tensor::InstanceMethod("detach", &Tensor::Detach), Tensor::InstanceMethod("backward", &Tensor::Backward)});
-
-        constructor = Napi::Persistent(func);
-        constructor.SuppressDestruct();
+                                 Tensor::InstanceMethod("sigmoid", &Tensor::Sigmoid),
+                                 Tensor::InstanceMethod("clamp_", &Tensor::ClampInPlace),
+                                 Tensor::InstanceMethod("sigmoid_", &Tensor::SigmoidInPlace), Tensor::InstanceMethod("cpu", &Tensor::Cpu),
+                                 Tensor::InstanceMethod("cuda", &Tensor::Cuda), Tensor::InstanceMethod("detach", &Tensor::Detach), Tensor::InstanceMethod("backward", &Tensor::Backward),
+                                 Tensor::InstanceMethod("contiguous", &Tensor::Contiguous),
+                                 Tensor::InstanceMethod("isContiguous", &Tensor::IsContiguous),
+                                 Tensor::InstanceAccessor("memoryFormat", &Tensor::MemoryFormat, nullptr),
+                                 Tensor::InstanceMethod("toMkldnn", &Tensor::ToMkldnn),
+                                 Tensor::InstanceMethod("toDense", &Tensor::ToDense),
+                                 Tensor::InstanceMethod("dequantize", &Tensor::Dequantize),
+                                 Tensor::InstanceMethod("intRepr", &Tensor::IntRepr),
+                                 Tensor::InstanceMethod("qScale", &Tensor::QScale),
+                                 Tensor::InstanceMethod("qZeroPoint", &Tensor::QZeroPoint),
+                                 Tensor::InstanceMethod("dispose", &Tensor::Dispose)});
+
+        AddonData::Get(env)->tensorConstructor = Napi::Persistent(func);
         exports.Set("Tensor", func);
         return exports;
     }
 
     bool Tensor::IsInstance(const Napi::Object &obj)
     {
-        return obj.InstanceOf(constructor.Value());
+        return obj.InstanceOf(AddonData::Get(obj.Env())->tensorConstructor.Value());
     }
 
     Tensor::Tensor(const Napi::CallbackInfo &info)
@@ -126,7 +277,7 @@ namespace nodeml_torch
         try
         {
             Napi::EscapableHandleScope scope(env);
-            auto newTensor = Tensor::constructor.New({});
+            auto newTensor = AddonData::Get(env)->tensorConstructor.New({});
             Napi::ObjectWrap<Tensor>::Unwrap(newTensor)->torchTensor = targetTorchTensor;
             return scope.Escape(newTensor).ToObject();
         }
@@ -147,20 +298,141 @@ namespace nodeml_torch
     {
         auto env = info.Env();
 
-        if (info.Length() > 1 && info[0].IsTypedArray() && info[1].IsArray())
+        if (info.Length() > 2 && info[0].IsTypedArray() && info[1].IsArray() && info[2].IsString())
+        {
+            try
+            {
+                auto data = info[0].As<Napi::TypedArray>();
+                auto dtype = stringToScalarType(info[2].ToString().Utf8Value());
+                auto tensor = torch::empty(shapeForArray(data, info[1].As<Napi::Array>()), torch::TensorOptions(dtype));
+                copyTypedArray(env, data, tensor);
+                return Tensor::FromTorchTensor(env, tensor);
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+        else if (info.Length() > 1 && info[0].IsTypedArray() && info[1].IsArray())
         {
-            return Tensor::FromTorchTensor(env,
-                                           typedArrayToTensor(env, info[0].As<Napi::TypedArray>(), info[1].As<Napi::Array>()));
+            try
+            {
+                return Tensor::FromTorchTensor(env,
+                                               typedArrayToTensor(env, info[0].As<Napi::TypedArray>(), info[1].As<Napi::Array>()));
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
         }
         else if (info.Length() > 0 && info[0].IsTypedArray())
         {
-            Tensor::FromTorchTensor(env,
-                                    typedArrayToTensor(env, info[0].As<Napi::TypedArray>(),
-                                                       Napi::Array::New(env, {info[0].As<Napi::TypedArray>().ElementLength()})));
+            try
+            {
+                auto data = info[0].As<Napi::TypedArray>();
+                auto shape = Napi::Array::New(env, 1);
+                shape.Set(uint32_t(0), Napi::Number::New(env, double(data.ElementLength())));
+                return Tensor::FromTorchTensor(env, typedArrayToTensor(env, data, shape));
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
         }
         return Napi::Value();
     }
 
+    Napi::Value Tensor::FromShared(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return Tensor::FromTorchTensor(env, tensorFromSharedDescriptor(env, info[0].ToObject()));
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::ToShared(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            auto descriptor = copyToShared(env, torchTensor);
+            auto result = Napi::Object::New(env);
+            result.Set("tensor", Tensor::FromTorchTensor(env, tensorFromSharedDescriptor(env, descriptor)));
+            result.Set("descriptor", descriptor);
+            return result;
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::Serialize(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            SerializeOptions options;
+            if (info.Length() > 0 && info[0].IsObject())
+            {
+                options = serializeOptionsFromObject(info[0].ToObject());
+            }
+
+            return serializeTensor(env, torchTensor, options);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::Deserialize(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            if (!info[0].IsTypedArray())
+            {
+                throw Napi::Error::New(env, "Expected A Buffer");
+            }
+
+            return Tensor::FromTorchTensor(env, deserializeTensor(env, info[0].As<Napi::TypedArray>()));
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::FrameLength(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            if (!info[0].IsTypedArray())
+            {
+                throw Napi::Error::New(env, "Expected A Buffer");
+            }
+
+            auto bytes = info[0].As<Napi::TypedArray>();
+            auto length = serializedFrameLength(static_cast<const uint8_t *>(bytes.ArrayBuffer().Data()) + bytes.ByteOffset(), bytes.ByteLength());
+            if (length < 0)
+            {
+                return env.Null();
+            }
+            return Napi::Number::New(env, double(length));
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
     Napi::Value Tensor::Shape(const Napi::CallbackInfo &info)
     {
         auto env = info.Env();
@@ -183,64 +455,75 @@ namespace nodeml_torch
 
         auto st = torchTensor.scalar_type();
 
+        // Views such as transposes and slices are laid out in logical order first
+        auto source = torchTensor.cpu().contiguous();
+
+        // Quantized tensors hand out their stored integers, dequantize() gives the real values
+        if (source.is_quantized())
+        {
+            source = source.int_repr();
+            st = source.scalar_type();
+        }
+
         switch (st)
         {
         case torch::ScalarType::Float:
-            return tensorToArray<float>(env, torchTensor);
+            return tensorToArray<float>(env, source);
         case torch::ScalarType::Double:
-            return tensorToArray<double>(env, torchTensor);
+            return tensorToArray<double>(env, source);
         case torch::ScalarType::Int:
-            return tensorToArray<int32_t>(env, torchTensor);
+            return tensorToArray<int32_t>(env, source);
         case torch::ScalarType::Byte:
-            return tensorToArray<uint8_t>(env, torchTensor);
+            return tensorToArray<uint8_t>(env, source);
+        case torch::ScalarType::Char:
+            return tensorToArray<int8_t>(env, source);
+        case torch::ScalarType::Short:
+            return tensorToArray<int16_t>(env, source);
         case torch::ScalarType::Long:
-            return tensorToArray<int64_t>(env, torchTensor);
+            return tensorToArray<int64_t>(env, source);
+        case torch::ScalarType::Half:
+        case torch::ScalarType::BFloat16:
+            return halfTensorToArray(env, source);
         case torch::ScalarType::Bool:
-            return tensorToArray<bool>(env, torchTensor, [=](Napi::Env env, bool value) -> Napi::Boolean
+            return tensorToArray<bool>(env, source, [=](Napi::Env env, bool value) -> Napi::Boolean
                                        { return Napi::Boolean::New(env, value); });
         default:
             throw Napi::TypeError::New(env, "Unsupported type");
         }
     }
 
-    // Napi::Value Tensor::ToMultiArray(const Napi::CallbackInfo &info)
-    // {
-
-    //     auto env = info.Env();
-
-    //     try
-    //     {
-    //         auto st = torchTensor.scalar_type();
-
-    //         switch (st)
-    //         {
-    //         case torch::ScalarType::Float:
-    //             return tensorToMultiArray<float>(env, torchTensor, [=](Napi::Env env, float value) -> Napi::Number
-    //                                              { return Napi::Number::New(env, value); });
-    //         case torch::ScalarType::Double:
-    //             return tensorToMultiArray<double>(env, torchTensor, [=](Napi::Env env, double value) -> Napi::Number
-    //                                               { return Napi::Number::New(env, value); });
-    //         case torch::ScalarType::Int:
-    //             return tensorToMultiArray<int32_t>(env, torchTensor, [=](Napi::Env env, int32_t value) -> Napi::Number
-    //                                                { return Napi::Number::New(env, value); });
-    //         case torch::ScalarType::Byte:
-    //             return tensorToMultiArray<uint8_t>(env, torchTensor, [=](Napi::Env env, uint8_t value) -> Napi::Number
-    //                                                { return Napi::Number::New(env, value); });
-    //         case torch::ScalarType::Long:
-    //             return tensorToMultiArray<int64_t>(env, torchTensor, [=](Napi::Env env, int64_t value) -> Napi::Number
-    //                                                { return Napi::Number::New(env, value); });
-    //         case torch::ScalarType::Bool:
-    //             return tensorToMultiArray<bool>(env, torchTensor, [=](Napi::Env env, bool value) -> Napi::Boolean
-    //                                             { return Napi::Boolean::New(env, value); });
-    //         default:
-    //             throw Napi::TypeError::New(env, "Unsupported type");
-    //         }
-    //     }
-    //     catch (const std::exception &e)
-    //     {
-    //         throw Napi::Error::New(env, e.what());
-    //     }
-    // }
+    Napi::Value Tensor::FromNestedArray(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            c10::optional<torch::ScalarType> dtype;
+            if (info.Length() > 1 && info[1].IsString())
+            {
+                dtype = stringToScalarType(info[1].ToString().Utf8Value());
+            }
+
+            return Tensor::FromTorchTensor(env, nestedArrayToTensor(env, info[0], dtype));
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::ToNestedArray(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return tensorToNestedArray(env, torchTensor);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
     Napi::Value Tensor::Reshape(const Napi::CallbackInfo &info)
     {
         auto env = info.Env();
@@ -348,6 +631,22 @@ namespace nodeml_torch
         {
             return Tensor::FromTorchTensor(env, torchTensor.toType(torch::ScalarType::Bool));
         }
+        else if (targetType == torchFloat16Type)
+        {
+            return Tensor::FromTorchTensor(env, torchTensor.toType(torch::ScalarType::Half));
+        }
+        else if (targetType == torchBFloat16Type)
+        {
+            return Tensor::FromTorchTensor(env, torchTensor.toType(torch::ScalarType::BFloat16));
+        }
+        else if (targetType == torchInt8Type)
+        {
+            return Tensor::FromTorchTensor(env, torchTensor.toType(torch::ScalarType::Char));
+        }
+        else if (targetType == torchInt16Type)
+        {
+            return Tensor::FromTorchTensor(env, torchTensor.toType(torch::ScalarType::Short));
+        }
 
         throw Napi::Error::New(env, "Unknown Type");
     }
@@ -356,23 +655,12 @@ namespace nodeml_torch
     {
         auto env = info.Env();
 
-        auto st = torchTensor.scalar_type();
-
-        switch (st)
+        try
+        {
+            return Napi::String::New(env, scalarTypeToString(torchTensor.scalar_type()));
+        }
+        catch (const std::exception &e)
         {
-        case torch::ScalarType::Float:
-            return Napi::String::New(env, torchFloatType);
-        case torch::ScalarType::Double:
-            return Napi::String::New(env, torchDoubleType);
-        case torch::ScalarType::Int:
-            return Napi::String::New(env, torchInt32Type);
-        case torch::ScalarType::Long:
-            return Napi::String::New(env, torchLongType);
-        case torch::ScalarType::Byte:
-            return Napi::String::New(env, torchUint8Type);
-        case torch::ScalarType::Bool:
-            return Napi::String::New(env, torchBooleanType);
-        default:
             throw Napi::TypeError::New(env, "Unsupported type");
         }
     }
@@ -387,14 +675,17 @@ namespace nodeml_torch
         auto env = info.Env();
         try
         {
+            if (auto out = outFromOptions(info, 1))
+            {
+                torch::add_out(out->torchTensor, torchTensor, napiValueToOperand(info[0]));
+                return out->Value();
+            }
+
             auto a = torchTensor;
 
             if (info[0].IsNumber())
             {
-                auto b = info[0].ToNumber();
-
-                return Tensor::FromTorchTensor(
-                    env, a + (utils::isNapiValueInt(env, b) ? b.Int32Value() : b.FloatValue()));
+                return Tensor::FromTorchTensor(env, a + napiNumberToScalar(info[0]));
             }
 
             auto b = FromObject(info[0])->torchTensor;
@@ -412,14 +703,17 @@ namespace nodeml_torch
         auto env = info.Env();
         try
         {
+            if (auto out = outFromOptions(info, 1))
+            {
+                torch::sub_out(out->torchTensor, torchTensor, napiValueToOperand(info[0]));
+                return out->Value();
+            }
+
             auto a = torchTensor;
 
             if (info[0].IsNumber())
             {
-                auto b = info[0].ToNumber();
-
-                return Tensor::FromTorchTensor(
-                    env, a - (utils::isNapiValueInt(env, b) ? b.Int32Value() : b.FloatValue()));
+                return Tensor::FromTorchTensor(env, a - napiNumberToScalar(info[0]));
             }
 
             auto b = FromObject(info[0])->torchTensor;
@@ -437,14 +731,17 @@ namespace nodeml_torch
         auto env = info.Env();
         try
         {
+            if (auto out = outFromOptions(info, 1))
+            {
+                torch::mul_out(out->torchTensor, torchTensor, napiValueToOperand(info[0]));
+                return out->Value();
+            }
+
             auto a = torchTensor;
 
             if (info[0].IsNumber())
             {
-                auto b = info[0].ToNumber();
-
-                return Tensor::FromTorchTensor(
-                    env, a * (utils::isNapiValueInt(env, b) ? b.Int32Value() : b.FloatValue()));
+                return Tensor::FromTorchTensor(env, a * napiNumberToScalar(info[0]));
             }
 
             auto b = FromObject(info[0])->torchTensor;
@@ -460,17 +757,19 @@ namespace nodeml_torch
     Napi::Value Tensor::Div(const Napi::CallbackInfo &info)
     {
         auto env = info.Env();
-
         try
         {
+            if (auto out = outFromOptions(info, 1))
+            {
+                torch::div_out(out->torchTensor, torchTensor, napiValueToOperand(info[0]));
+                return out->Value();
+            }
+
             auto a = torchTensor;
 
             if (info[0].IsNumber())
             {
-                auto b = info[0].ToNumber();
-
-                return Tensor::FromTorchTensor(
-                    env, a / (utils::isNapiValueInt(env, b) ? b.Int32Value() : b.FloatValue()));
+                return Tensor::FromTorchTensor(env, a / napiNumberToScalar(info[0]));
             }
 
             auto b = FromObject(info[0])->torchTensor;
@@ -483,20 +782,21 @@ namespace nodeml_torch
         }
     }
 
-    Napi::Value Tensor::Index(const Napi::CallbackInfo &info)
+    Napi::Value Tensor::AddInPlace(const Napi::CallbackInfo &info)
     {
         auto env = info.Env();
-
         try
         {
-            std::vector<torch::indexing::TensorIndex> indexes;
-
-            for (int i = 0; i < info.Length(); i++)
+            if (info[0].IsNumber())
             {
-                indexes.push_back(utils::napiValueToTorchIndex(env, info[i]));
+                torchTensor.add_(napiNumberToScalar(info[0]));
+            }
+            else
+            {
+                torchTensor.add_(FromObject(info[0])->torchTensor);
             }
 
-            return Tensor::FromTorchTensor(env, torchTensor.index(indexes));
+            return info.This();
         }
         catch (const std::exception &e)
         {
@@ -504,24 +804,21 @@ namespace nodeml_torch
         }
     }
 
-    Napi::Value Tensor::IndexPut(const Napi::CallbackInfo &info)
+    Napi::Value Tensor::SubInPlace(const Napi::CallbackInfo &info)
     {
         auto env = info.Env();
-
         try
         {
-            std::vector<torch::indexing::TensorIndex> indexes;
-
-            for (int i = 1; i < info.Length(); i++)
+            if (info[0].IsNumber())
             {
-                indexes.push_back(utils::napiValueToTorchIndex(env, info[i]));
+                torchTensor.sub_(napiNumberToScalar(info[0]));
+            }
+            else
+            {
+                torchTensor.sub_(FromObject(info[0])->torchTensor);
             }
 
-            auto b = FromObject(info[0])->torchTensor;
-
-            torchTensor.index_put_(indexes, b);
-
-            return Napi::Value();
+            return info.This();
         }
         catch (const std::exception &e)
         {
@@ -529,16 +826,21 @@ namespace nodeml_torch
         }
     }
 
-    Napi::Value Tensor::MatMul(const Napi::CallbackInfo &info)
+    Napi::Value Tensor::MulInPlace(const Napi::CallbackInfo &info)
     {
         auto env = info.Env();
         try
         {
-            auto a = torchTensor;
-
-            auto b = FromObject(info[0])->torchTensor;
+            if (info[0].IsNumber())
+            {
+                torchTensor.mul_(napiNumberToScalar(info[0]));
+            }
+            else
+            {
+                torchTensor.mul_(FromObject(info[0])->torchTensor);
+            }
 
-            return Tensor::FromTorchTensor(env, a.matmul(b));
+            return info.This();
         }
         catch (const std::exception &e)
         {
@@ -546,12 +848,97 @@ namespace nodeml_torch
         }
     }
 
-    Napi::Value Tensor::AMax(const Napi::CallbackInfo &info)
+    Napi::Value Tensor::DivInPlace(const Napi::CallbackInfo &info)
     {
         auto env = info.Env();
         try
         {
-            return Tensor::FromTorchTensor(env, torchTensor.amax(info[0].As<Napi::Number>().Int64Value()));
+            if (info[0].IsNumber())
+            {
+                torchTensor.div_(napiNumberToScalar(info[0]));
+            }
+            else
+            {
+                torchTensor.div_(FromObject(info[0])->torchTensor);
+            }
+
+            return info.This();
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::Index(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+
+        try
+        {
+            std::vector<torch::indexing::TensorIndex> indexes;
+
+            for (int i = 0; i < info.Length(); i++)
+            {
+                indexes.push_back(utils::napiValueToTorchIndex(env, info[i]));
+            }
+
+            return Tensor::FromTorchTensor(env, torchTensor.index(indexes));
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::IndexPut(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+
+        try
+        {
+            std::vector<torch::indexing::TensorIndex> indexes;
+
+            for (int i = 1; i < info.Length(); i++)
+            {
+                indexes.push_back(utils::napiValueToTorchIndex(env, info[i]));
+            }
+
+            auto b = FromObject(info[0])->torchTensor;
+
+            torchTensor.index_put_(indexes, b);
+
+            return Napi::Value();
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::MatMul(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            auto a = torchTensor;
+
+            auto b = FromObject(info[0])->torchTensor;
+
+            return Tensor::FromTorchTensor(env, a.matmul(b));
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::AMax(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return Tensor::FromTorchTensor(env, torchTensor.amax(info[0].As<Napi::Number>().Int64Value()));
         }
         catch (const std::exception &e)
         {
@@ -639,6 +1026,260 @@ namespace nodeml_torch
         }
     }
 
+    // Runs op inline or on the libuv pool, ops with several outputs return an array
+    static Napi::Value runSelection(Napi::Env env, bool async, const std::function<std::vector<torch::Tensor>()> &op)
+    {
+        auto toValue = [](Napi::Env env, std::vector<torch::Tensor> result) -> Napi::Value
+        {
+            if (result.size() == 1)
+            {
+                return Tensor::FromTorchTensor(env, result[0]);
+            }
+
+            return utils::vectorToNapiArray(env, result);
+        };
+
+        if (!async)
+        {
+            return toValue(env, op());
+        }
+
+        auto worker = new FunctionWorker<std::vector<torch::Tensor>>(env, op, toValue);
+        worker->Queue();
+        return worker->GetPromise();
+    }
+
+    static int64_t intArg(const Napi::CallbackInfo &info, size_t index, int64_t fallback)
+    {
+        return info.Length() > index && info[index].IsNumber() ? info[index].ToNumber().Int64Value() : fallback;
+    }
+
+    static double doubleArg(const Napi::CallbackInfo &info, size_t index, double fallback)
+    {
+        return info.Length() > index && info[index].IsNumber() ? info[index].ToNumber().DoubleValue() : fallback;
+    }
+
+    static bool boolArg(const Napi::CallbackInfo &info, size_t index, bool fallback)
+    {
+        return info.Length() > index && info[index].IsBoolean() ? info[index].ToBoolean().Value() : fallback;
+    }
+
+    static c10::optional<at::Generator> generatorArg(const Napi::CallbackInfo &info, size_t index)
+    {
+        return info.Length() > index ? Generator::FromValue(info[index]) : c10::nullopt;
+    }
+
+    static Napi::Value topk(const Napi::CallbackInfo &info, const torch::Tensor &tensor, bool async)
+    {
+        auto k = intArg(info, 0, 1);
+        auto dim = intArg(info, 1, -1);
+        auto largest = boolArg(info, 2, true);
+        auto sorted = boolArg(info, 3, true);
+
+        return runSelection(info.Env(), async, [=]() -> std::vector<torch::Tensor>
+                            {
+                                auto [values, indices] = tensor.topk(k, dim, largest, sorted);
+                                return {values, indices}; });
+    }
+
+    static Napi::Value kthvalue(const Napi::CallbackInfo &info, const torch::Tensor &tensor, bool async)
+    {
+        auto k = intArg(info, 0, 1);
+        auto dim = intArg(info, 1, -1);
+        auto keepDim = boolArg(info, 2, false);
+
+        return runSelection(info.Env(), async, [=]() -> std::vector<torch::Tensor>
+                            {
+                                auto [values, indices] = tensor.kthvalue(k, dim, keepDim);
+                                return {values, indices}; });
+    }
+
+    static Napi::Value softmax(const Napi::CallbackInfo &info, const torch::Tensor &tensor, bool async, bool log)
+    {
+        auto dim = intArg(info, 0, -1);
+
+        return runSelection(info.Env(), async, [=]() -> std::vector<torch::Tensor>
+                            { return {log ? tensor.log_softmax(dim) : tensor.softmax(dim)}; });
+    }
+
+    static Napi::Value multinomial(const Napi::CallbackInfo &info, const torch::Tensor &tensor, bool async)
+    {
+        auto numSamples = intArg(info, 0, 1);
+        auto replacement = boolArg(info, 1, false);
+        auto generator = generatorArg(info, 2);
+
+        return runSelection(info.Env(), async, [=]() -> std::vector<torch::Tensor>
+                            { return {tensor.multinomial(numSamples, replacement, generator)}; });
+    }
+
+    // Nucleus sampling over the last dim of logits, fused so only one softmax runs on the masked scores
+    static Napi::Value sampleTopP(const Napi::CallbackInfo &info, const torch::Tensor &tensor, bool async)
+    {
+        sampling::SamplingOptions options;
+        options.topP = doubleArg(info, 0, 0.9);
+        options.temperature = doubleArg(info, 1, 1.0);
+        auto generator = generatorArg(info, 2);
+
+        return runSelection(info.Env(), async, [=]() -> std::vector<torch::Tensor>
+                            { return {sampling::sample(tensor, options, generator)}; });
+    }
+
+    Napi::Value Tensor::Topk(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return topk(info, torchTensor, false);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::TopkAsync(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return topk(info, torchTensor, true);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::Kthvalue(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return kthvalue(info, torchTensor, false);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::KthvalueAsync(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return kthvalue(info, torchTensor, true);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::Softmax(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return softmax(info, torchTensor, false, false);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::SoftmaxAsync(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return softmax(info, torchTensor, true, false);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::LogSoftmax(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return softmax(info, torchTensor, false, true);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::LogSoftmaxAsync(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return softmax(info, torchTensor, true, true);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::Multinomial(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return multinomial(info, torchTensor, false);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::MultinomialAsync(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return multinomial(info, torchTensor, true);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::SampleTopP(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return sampleTopP(info, torchTensor, false);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::SampleTopPAsync(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return sampleTopP(info, torchTensor, true);
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
     Napi::Value Tensor::View(const Napi::CallbackInfo &info)
     {
         auto env = info.Env();
@@ -685,7 +1326,27 @@ namespace nodeml_torch
         try
         {
 
-            return Tensor::FromTorchTensor(env, torchTensor.clamp(info[0].As<Napi::Number>().Int64Value(), info[1].As<Napi::Number>().Int64Value()));
+            if (auto out = outFromOptions(info, 2))
+            {
+                torch::clamp_out(out->torchTensor, torchTensor, napiNumberToScalar(info[0]), napiNumberToScalar(info[1]));
+                return out->Value();
+            }
+
+            return Tensor::FromTorchTensor(env, torchTensor.clamp(napiNumberToScalar(info[0]), napiNumberToScalar(info[1])));
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::ClampInPlace(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            torchTensor.clamp_(napiNumberToScalar(info[0]), napiNumberToScalar(info[1]));
+            return info.This();
         }
         catch (const std::exception &e)
         {
@@ -698,6 +1359,11 @@ namespace nodeml_torch
         auto env = info.Env();
         try
         {
+            if (auto out = outFromOptions(info, 0))
+            {
+                torch::sigmoid_out(out->torchTensor, torchTensor);
+                return out->Value();
+            }
 
             return Tensor::FromTorchTensor(env, torchTensor.sigmoid());
         }
@@ -707,6 +1373,20 @@ namespace nodeml_torch
         }
     }
 
+    Napi::Value Tensor::SigmoidInPlace(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            torchTensor.sigmoid_();
+            return info.This();
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
     Napi::Value Tensor::Cuda(const Napi::CallbackInfo &info)
     {
         auto env = info.Env();
@@ -763,6 +1443,140 @@ namespace nodeml_torch
         }
     }
 
+    static torch::MemoryFormat memoryFormatFromOptions(const Napi::CallbackInfo &info)
+    {
+        if (info.Length() > 0 && info[0].IsObject() && info[0].ToObject().Has("memoryFormat"))
+        {
+            return stringToMemoryFormat(info[0].ToObject().Get("memoryFormat").ToString().Utf8Value());
+        }
+
+        return torch::MemoryFormat::Contiguous;
+    }
+
+    Napi::Value Tensor::Contiguous(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return Tensor::FromTorchTensor(env, torchTensor.contiguous(memoryFormatFromOptions(info)));
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::IsContiguous(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return Napi::Boolean::New(env, torchTensor.is_contiguous(memoryFormatFromOptions(info)));
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::MemoryFormat(const Napi::CallbackInfo &info)
+    {
+        return Napi::String::New(info.Env(), memoryFormatToString(torchTensor.suggest_memory_format()));
+    }
+
+    Napi::Value Tensor::ToMkldnn(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return Tensor::FromTorchTensor(env, torchTensor.to_mkldnn());
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::ToDense(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return Tensor::FromTorchTensor(env, torchTensor.to_dense());
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::Dequantize(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return Tensor::FromTorchTensor(env, torchTensor.dequantize());
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::IntRepr(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            return Tensor::FromTorchTensor(env, torchTensor.int_repr());
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::QScale(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            if (torchTensor.qscheme() == torch::kPerChannelAffine || torchTensor.qscheme() == torch::kPerChannelSymmetric)
+            {
+                return Tensor::FromTorchTensor(env, torchTensor.q_per_channel_scales());
+            }
+            return Napi::Number::New(env, torchTensor.q_scale());
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::QZeroPoint(const Napi::CallbackInfo &info)
+    {
+        auto env = info.Env();
+        try
+        {
+            if (torchTensor.qscheme() == torch::kPerChannelAffine || torchTensor.qscheme() == torch::kPerChannelSymmetric)
+            {
+                return Tensor::FromTorchTensor(env, torchTensor.q_per_channel_zero_points());
+            }
+            return Napi::Number::New(env, double(torchTensor.q_zero_point()));
+        }
+        catch (const std::exception &e)
+        {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+    Napi::Value Tensor::Dispose(const Napi::CallbackInfo &info)
+    {
+        // Same empty placeholder the constructor starts with, so later calls fail on shape rather than crash
+        torchTensor = torch::empty(0);
+        return info.Env().Undefined();
+    }
+
     Napi::Value Tensor::toString(const Napi::CallbackInfo &info)
     {
         return Napi::String::New(info.Env(), torchTensor.toString());
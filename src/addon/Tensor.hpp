@@ -13,8 +13,6 @@ namespace nodeml_torch
     {
 
     public:
-        static Napi::FunctionReference constructor;
-
         torch::Tensor torchTensor;
 
         static Napi::Object Init(Napi::Env env, Napi::Object exports);
@@ -29,12 +27,26 @@ namespace nodeml_torch
 
         static Napi::Value FromTypedArray(const Napi::CallbackInfo &info);
 
+        static Napi::Value FromShared(const Napi::CallbackInfo &info);
+
+        // { tensor, descriptor }: a copy backed by a SharedArrayBuffer and the descriptor other threads pass to fromShared
+        Napi::Value ToShared(const Napi::CallbackInfo &info);
+
+        // A Buffer in the compact wire format, see Serialization.hpp
+        Napi::Value Serialize(const Napi::CallbackInfo &info);
+
+        static Napi::Value Deserialize(const Napi::CallbackInfo &info);
+
+        // Bytes of the frame at the start of the buffer, null until its header is complete
+        static Napi::Value FrameLength(const Napi::CallbackInfo &info);
+
         Napi::Value Shape(const Napi::CallbackInfo &info);
 
         Napi::Value ToArray(const Napi::CallbackInfo &info);
 
-        // 23 times slower than JS equivalent
-        // Napi::Value ToMultiArray(const Napi::CallbackInfo &info);
+        static Napi::Value FromNestedArray(const Napi::CallbackInfo &info);
+
+        Napi::Value ToNestedArray(const Napi::CallbackInfo &info);
 
         Napi::Value Reshape(const Napi::CallbackInfo &info);
 
@@ -60,6 +72,14 @@ namespace nodeml_torch
 
         Napi::Value Div(const Napi::CallbackInfo &info);
 
+        Napi::Value AddInPlace(const Napi::CallbackInfo &info);
+
+        Napi::Value SubInPlace(const Napi::CallbackInfo &info);
+
+        Napi::Value MulInPlace(const Napi::CallbackInfo &info);
+
+        Napi::Value DivInPlace(const Napi::CallbackInfo &info);
+
         Napi::Value Index(const Napi::CallbackInfo &info);
 
         Napi::Value IndexPut(const Napi::CallbackInfo &info);
@@ -74,6 +94,30 @@ namespace nodeml_torch
 
         Napi::Value Max(const Napi::CallbackInfo &info);
 
+        Napi::Value Topk(const Napi::CallbackInfo &info);
+
+        Napi::Value TopkAsync(const Napi::CallbackInfo &info);
+
+        Napi::Value Kthvalue(const Napi::CallbackInfo &info);
+
+        Napi::Value KthvalueAsync(const Napi::CallbackInfo &info);
+
+        Napi::Value Softmax(const Napi::CallbackInfo &info);
+
+        Napi::Value SoftmaxAsync(const Napi::CallbackInfo &info);
+
+        Napi::Value LogSoftmax(const Napi::CallbackInfo &info);
+
+        Napi::Value LogSoftmaxAsync(const Napi::CallbackInfo &info);
+
+        Napi::Value Multinomial(const Napi::CallbackInfo &info);
+
+        Napi::Value MultinomialAsync(const Napi::CallbackInfo &info);
+
+        Napi::Value SampleTopP(const Napi::CallbackInfo &info);
+
+        Napi::Value SampleTopPAsync(const Napi::CallbackInfo &info);
+
         Napi::Value View(const Napi::CallbackInfo &info);
 
         Napi::Value Any(const Napi::CallbackInfo &info);
@@ -82,6 +126,10 @@ namespace nodeml_torch
 
         Napi::Value Sigmoid(const Napi::CallbackInfo &info);
 
+        Napi::Value ClampInPlace(const Napi::CallbackInfo &info);
+
+        Napi::Value SigmoidInPlace(const Napi::CallbackInfo &info);
+
         Napi::Value Cuda(const Napi::CallbackInfo &info);
 
         Napi::Value Cpu(const Napi::CallbackInfo &info);
@@ -90,9 +138,44 @@ namespace nodeml_torch
 
         Napi::Value Backward(const Napi::CallbackInfo &info);
 
+        Napi::Value Contiguous(const Napi::CallbackInfo &info);
+
+        Napi::Value IsContiguous(const Napi::CallbackInfo &info);
+
+        // The layout libtorch would pick for results derived from this tensor
+        Napi::Value MemoryFormat(const Napi::CallbackInfo &info);
+
+        Napi::Value ToMkldnn(const Napi::CallbackInfo &info);
+
+        Napi::Value ToDense(const Napi::CallbackInfo &info);
+
+        Napi::Value Dequantize(const Napi::CallbackInfo &info);
+
+        // The stored integers of a quantized tensor
+        Napi::Value IntRepr(const Napi::CallbackInfo &info);
+
+        Napi::Value QScale(const Napi::CallbackInfo &info);
+
+        Napi::Value QZeroPoint(const Napi::CallbackInfo &info);
+
+        // Drops this wrapper's reference to the storage without waiting for GC
+        Napi::Value Dispose(const Napi::CallbackInfo &info);
+
         static Napi::Function GetClass(Napi::Env env);
 
         Napi::Value toString(const Napi::CallbackInfo &info);
     };
 
+    // The shape has to cover the array exactly, anything larger would read past its end
+    std::vector<int64_t> shapeForArray(const Napi::TypedArray &data, const Napi::Array &shape_array);
+
+    // dtype a typed array converts to, Uint16Array and Uint32Array widen to int32 and long
+    torch::ScalarType typedArrayScalarType(Napi::Env env, const Napi::TypedArray &data);
+
+    // Copies the array into dst converting to its dtype, a Uint16Array into a float16 or bfloat16 dst is taken
+    // as raw bits. dst must have exactly as many elements as the array
+    void copyTypedArray(Napi::Env env, const Napi::TypedArray &data, torch::Tensor &dst);
+
+    torch::Tensor typedArrayToTensor(Napi::Env env, const Napi::TypedArray &data, const Napi::Array &shape);
+
 }
\ No newline at end of file
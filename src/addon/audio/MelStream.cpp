@@ -0,0 +1,109 @@
+#include <addon/audio/MelStream.hpp>
+#include <addon/FunctionWorker.hpp>
+#include <addon/Tensor.hpp>
+
+namespace nodeml_torch
+{
+    namespace audio
+    {
+        Napi::Object MelStream::Init(Napi::Env env, Napi::Object exports)
+        {
+            auto func = DefineClass(env, "MelStream",
+                                    {
+                                        MelStream::InstanceMethod("push", &MelStream::Push),
+                                        MelStream::InstanceMethod("reset", &MelStream::Reset),
+                                        MelStream::InstanceAccessor("pending", &MelStream::Pending, nullptr),
+                                    });
+
+            exports.Set("MelStream", func);
+            return exports;
+        }
+
+        MelStream::MelStream(const Napi::CallbackInfo &info) : ObjectWrap(info)
+        {
+            auto env = info.Env();
+            try
+            {
+                state = std::make_shared<MelStreamState>();
+                state->options = info.Length() > 0 && info[0].IsObject() ? melOptionsFromObject(info[0].ToObject()) : MelOptions();
+
+                // Centering would pad every chunk edge, the carried overlap replaces it
+                state->options.spectrogram.center = false;
+                state->filterbank = melFilterbank(state->options);
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value MelStream::Push(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto chunk = signalFromValue(info[0]).samples.contiguous();
+                auto state = this->state;
+
+                // Frames are cut on the main thread so each promise gets exactly the frames its own chunk completed,
+                // in push order whichever worker runs first; the worker only computes the features
+                torch::Tensor samples;
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    auto data = chunk.data_ptr<float>();
+                    state->pending.insert(state->pending.end(), data, data + chunk.numel());
+
+                    auto nFft = state->options.spectrogram.nFft;
+                    auto hop = state->options.spectrogram.hopLength;
+                    auto available = int64_t(state->pending.size());
+
+                    if (available >= nFft)
+                    {
+                        auto frames = (available - nFft) / hop + 1;
+                        auto used = (frames - 1) * hop + nFft;
+                        samples = torch::from_blob(state->pending.data(), {used}, torch::TensorOptions(torch::kFloat32)).clone();
+                        state->pending.erase(state->pending.begin(), state->pending.begin() + std::min(frames * hop, available));
+                    }
+                }
+
+                auto worker = new FunctionWorker<torch::Tensor>(
+                    env,
+                    [=]() -> torch::Tensor
+                    {
+                        torch::NoGradGuard no_grad;
+
+                        if (!samples.defined())
+                        {
+                            return torch::empty({state->options.nMels, 0});
+                        }
+
+                        return computeMelSpectrogram(samples, state->options, state->filterbank);
+                    },
+                    [=](Napi::Env env, torch::Tensor value) -> Napi::Value
+                    {
+                        return Tensor::FromTorchTensor(env, value);
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value MelStream::Reset(const Napi::CallbackInfo &info)
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->pending.clear();
+            return info.Env().Undefined();
+        }
+
+        Napi::Value MelStream::Pending(const Napi::CallbackInfo &info)
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            return Napi::Number::New(info.Env(), double(state->pending.size()));
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <napi.h>
+
+#include <addon/audio/features.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace nodeml_torch
+{
+    namespace audio
+    {
+        struct MelStreamState
+        {
+            std::mutex mutex;
+            MelOptions options;
+            torch::Tensor filterbank;
+            // Samples not yet covered by a full frame, carried into the next push
+            std::vector<float> pending;
+        };
+
+        // Live mel features: frames are emitted as soon as nFft samples are available, the overlap stays buffered
+        class MelStream : public Napi::ObjectWrap<MelStream>
+        {
+
+        public:
+            std::shared_ptr<MelStreamState> state;
+
+            static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+            MelStream(const Napi::CallbackInfo &info);
+
+            Napi::Value Push(const Napi::CallbackInfo &info);
+
+            Napi::Value Reset(const Napi::CallbackInfo &info);
+
+            Napi::Value Pending(const Napi::CallbackInfo &info);
+        };
+    }
+}
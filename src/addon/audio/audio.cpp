@@ -0,0 +1,131 @@
+#include <addon/audio/audio.hpp>
+#include <addon/audio/features.hpp>
+#include <addon/audio/MelStream.hpp>
+#include <addon/FunctionWorker.hpp>
+#include <addon/Tensor.hpp>
+
+namespace nodeml_torch
+{
+    namespace audio
+    {
+        static Napi::Object optionsArg(const Napi::CallbackInfo &info, size_t index)
+        {
+            return info.Length() > index && info[index].IsObject() ? info[index].ToObject() : Napi::Object::New(info.Env());
+        }
+
+        // The signal is captured alongside the work so a Float32Array stays alive until the result is back on the main thread
+        static Napi::Value queueSignalWork(Napi::Env env, const Signal &signal, std::function<torch::Tensor(const torch::Tensor &)> work)
+        {
+            auto worker = new FunctionWorker<torch::Tensor>(
+                env,
+                [=]() -> torch::Tensor
+                {
+                    torch::NoGradGuard no_grad;
+                    return work(signal.samples);
+                },
+                [=](Napi::Env env, torch::Tensor value) -> Napi::Value
+                {
+                    return Tensor::FromTorchTensor(env, value);
+                });
+
+            worker->Queue();
+            return worker->GetPromise();
+        }
+
+        Napi::Value stft(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto signal = signalFromValue(info[0]);
+                auto options = spectrogramOptionsFromObject(optionsArg(info, 1));
+
+                return queueSignalWork(env, signal, [=](const torch::Tensor &samples)
+                                       { return computeSpectrogram(samples, options); });
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value melSpectrogram(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto signal = signalFromValue(info[0]);
+                auto options = melOptionsFromObject(optionsArg(info, 1));
+
+                return queueSignalWork(env, signal, [=](const torch::Tensor &samples)
+                                       { return computeMelSpectrogram(samples, options, melFilterbank(options)); });
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value mfcc(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto signal = signalFromValue(info[0]);
+                auto object = optionsArg(info, 1);
+                auto options = melOptionsFromObject(object);
+                auto nMfcc = object.Has("nMfcc") ? object.Get("nMfcc").ToNumber().Int64Value() : 40;
+                auto topDb = object.Has("topDb") ? object.Get("topDb").ToNumber().DoubleValue() : 80.0;
+
+                return queueSignalWork(env, signal, [=](const torch::Tensor &samples)
+                                       { return computeMfcc(samples, options, nMfcc, topDb); });
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value resample(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto signal = signalFromValue(info[0]);
+                auto origFreq = info[1].ToNumber().Int64Value();
+                auto newFreq = info[2].ToNumber().Int64Value();
+                auto object = optionsArg(info, 3);
+                auto lowpassFilterWidth = object.Has("lowpassFilterWidth") ? object.Get("lowpassFilterWidth").ToNumber().Int64Value() : 6;
+                auto rolloff = object.Has("rolloff") ? object.Get("rolloff").ToNumber().DoubleValue() : 0.99;
+
+                if (origFreq <= 0 || newFreq <= 0)
+                {
+                    throw Napi::Error::New(env, "Sample rates must be positive");
+                }
+
+                return queueSignalWork(env, signal, [=](const torch::Tensor &samples)
+                                       { return resampleSignal(samples, origFreq, newFreq, lowpassFilterWidth, rolloff); });
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Object Init(Napi::Env env, Napi::Object exports)
+        {
+            auto myExports = Napi::Object::New(env);
+
+            MelStream::Init(env, myExports);
+
+            myExports.Set("stft", Napi::Function::New(env, stft));
+            myExports.Set("melSpectrogram", Napi::Function::New(env, melSpectrogram));
+            myExports.Set("mfcc", Napi::Function::New(env, mfcc));
+            myExports.Set("resample", Napi::Function::New(env, resample));
+
+            exports.Set("audio", myExports);
+
+            return exports;
+        }
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <napi.h>
+
+namespace nodeml_torch
+{
+    namespace audio
+    {
+        Napi::Value stft(const Napi::CallbackInfo &info);
+
+        Napi::Value melSpectrogram(const Napi::CallbackInfo &info);
+
+        Napi::Value mfcc(const Napi::CallbackInfo &info);
+
+        Napi::Value resample(const Napi::CallbackInfo &info);
+
+        Napi::Object Init(Napi::Env env, Napi::Object exports);
+    }
+}
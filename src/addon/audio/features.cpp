@@ -0,0 +1,222 @@
+#include <addon/audio/features.hpp>
+#include <addon/Tensor.hpp>
+
+#include <numeric>
+
+namespace nodeml_torch
+{
+    namespace audio
+    {
+        namespace F = torch::nn::functional;
+
+        static const double pi = 3.14159265358979323846;
+
+        static double hzToMel(double hz)
+        {
+            return 2595.0 * std::log10(1.0 + hz / 700.0);
+        }
+
+        static torch::Tensor melToHz(const torch::Tensor &mel)
+        {
+            return 700.0 * (torch::pow(10.0, mel / 2595.0) - 1.0);
+        }
+
+        Signal signalFromValue(const Napi::Value &value)
+        {
+            Signal signal;
+
+            if (value.IsTypedArray() && value.As<Napi::TypedArray>().TypedArrayType() == napi_float32_array)
+            {
+                auto data = value.As<Napi::Float32Array>();
+                signal.keepAlive = std::make_shared<Napi::Reference<Napi::Float32Array>>(Napi::Persistent(data));
+                signal.samples = torch::from_blob(data.Data(), {int64_t(data.ElementLength())}, torch::TensorOptions(torch::kFloat32));
+                return signal;
+            }
+
+            signal.samples = Tensor::FromObject(value)->torchTensor.to(torch::kFloat32);
+            return signal;
+        }
+
+        SpectrogramOptions spectrogramOptionsFromObject(const Napi::Object &obj)
+        {
+            SpectrogramOptions options;
+
+            if (obj.Has("nFft"))
+            {
+                options.nFft = obj.Get("nFft").ToNumber().Int64Value();
+            }
+
+            options.winLength = obj.Has("winLength") ? obj.Get("winLength").ToNumber().Int64Value() : options.nFft;
+            options.hopLength = obj.Has("hopLength") ? obj.Get("hopLength").ToNumber().Int64Value() : options.winLength / 2;
+
+            if (obj.Has("center"))
+            {
+                options.center = obj.Get("center").ToBoolean().Value();
+            }
+
+            if (obj.Has("power"))
+            {
+                options.power = obj.Get("power").IsNull() ? 0.0 : obj.Get("power").ToNumber().DoubleValue();
+            }
+
+            if (obj.Has("window"))
+            {
+                options.window = obj.Get("window").ToString().Utf8Value();
+            }
+
+            return options;
+        }
+
+        MelOptions melOptionsFromObject(const Napi::Object &obj)
+        {
+            MelOptions options;
+            options.spectrogram = spectrogramOptionsFromObject(obj);
+
+            if (obj.Has("sampleRate"))
+            {
+                options.sampleRate = obj.Get("sampleRate").ToNumber().Int64Value();
+            }
+
+            if (obj.Has("nMels"))
+            {
+                options.nMels = obj.Get("nMels").ToNumber().Int64Value();
+            }
+
+            if (obj.Has("fMin"))
+            {
+                options.fMin = obj.Get("fMin").ToNumber().DoubleValue();
+            }
+
+            if (obj.Has("fMax"))
+            {
+                options.fMax = obj.Get("fMax").ToNumber().DoubleValue();
+            }
+
+            if (obj.Has("log"))
+            {
+                options.log = obj.Get("log").ToBoolean().Value();
+            }
+
+            return options;
+        }
+
+        static torch::Tensor makeWindow(const SpectrogramOptions &options)
+        {
+            if (options.window == "hann")
+            {
+                return torch::hann_window(options.winLength);
+            }
+            else if (options.window == "hamming")
+            {
+                return torch::hamming_window(options.winLength);
+            }
+            else if (options.window == "rect")
+            {
+                return torch::ones({options.winLength});
+            }
+
+            throw std::invalid_argument("Unknown window " + options.window + ", expected 'hann', 'hamming' or 'rect'");
+        }
+
+        torch::Tensor computeSpectrogram(const torch::Tensor &signal, const SpectrogramOptions &options)
+        {
+            auto window = makeWindow(options).to(signal.device());
+            auto complex = torch::stft(signal, options.nFft, options.hopLength, options.winLength, window, options.center, "reflect", false, true, true);
+
+            if (options.power <= 0.0)
+            {
+                return torch::view_as_real(complex);
+            }
+
+            auto magnitude = complex.abs();
+            return options.power == 1.0 ? magnitude : magnitude.pow(options.power);
+        }
+
+        torch::Tensor melFilterbank(const MelOptions &options)
+        {
+            auto nFreqs = options.spectrogram.nFft / 2 + 1;
+            auto fMax = options.fMax > 0.0 ? options.fMax : options.sampleRate / 2.0;
+
+            auto allFreqs = torch::linspace(0, options.sampleRate / 2, nFreqs, torch::TensorOptions(torch::kFloat64));
+            auto melPoints = torch::linspace(hzToMel(options.fMin), hzToMel(fMax), options.nMels + 2, torch::TensorOptions(torch::kFloat64));
+            auto freqPoints = melToHz(melPoints);
+
+            auto freqDiff = freqPoints.narrow(0, 1, options.nMels + 1) - freqPoints.narrow(0, 0, options.nMels + 1);
+            auto slopes = freqPoints.unsqueeze(0) - allFreqs.unsqueeze(1);
+            auto down = -slopes.narrow(1, 0, options.nMels) / freqDiff.narrow(0, 0, options.nMels);
+            auto up = slopes.narrow(1, 2, options.nMels) / freqDiff.narrow(0, 1, options.nMels);
+
+            return torch::clamp_min(torch::min(down, up), 0.0).to(torch::kFloat32);
+        }
+
+        torch::Tensor computeMelSpectrogram(const torch::Tensor &signal, const MelOptions &options, const torch::Tensor &filterbank)
+        {
+            auto spec = computeSpectrogram(signal, options.spectrogram);
+            auto mel = torch::matmul(spec.transpose(-1, -2), filterbank.to(spec.device())).transpose(-1, -2);
+            return options.log ? mel.clamp_min(1e-10).log() : mel;
+        }
+
+        torch::Tensor dctMatrix(int64_t nMfcc, int64_t nMels)
+        {
+            auto n = torch::arange(nMels, torch::TensorOptions(torch::kFloat64));
+            auto k = torch::arange(nMfcc, torch::TensorOptions(torch::kFloat64)).unsqueeze(1);
+            auto dct = torch::cos(pi / nMels * (n + 0.5) * k);
+            dct[0] *= 1.0 / std::sqrt(2.0);
+            dct *= std::sqrt(2.0 / nMels);
+            return dct.t().to(torch::kFloat32);
+        }
+
+        torch::Tensor computeMfcc(const torch::Tensor &signal, const MelOptions &options, int64_t nMfcc, double topDb)
+        {
+            auto melOptions = options;
+            melOptions.log = false;
+            auto mel = computeMelSpectrogram(signal, melOptions, melFilterbank(melOptions));
+
+            // Power to decibels with the floor torchaudio's AmplitudeToDB applies
+            auto db = 10.0 * mel.clamp_min(1e-10).log10();
+            if (topDb > 0.0)
+            {
+                db = torch::max(db, db.amax({-2, -1}, true) - topDb);
+            }
+
+            return torch::matmul(db.transpose(-1, -2), dctMatrix(nMfcc, options.nMels).to(db.device())).transpose(-1, -2);
+        }
+
+        torch::Tensor resampleSignal(const torch::Tensor &signal, int64_t origFreq, int64_t newFreq, int64_t lowpassFilterWidth, double rolloff)
+        {
+            if (origFreq == newFreq)
+            {
+                // The signal can be a view of a JS typed array, the result must own its samples
+                return signal.clone();
+            }
+
+            auto gcd = std::gcd(origFreq, newFreq);
+            auto orig = origFreq / gcd;
+            auto target = newFreq / gcd;
+
+            auto baseFreq = std::min(orig, target) * rolloff;
+            auto width = int64_t(std::ceil(lowpassFilterWidth * orig / baseFreq));
+
+            auto options = torch::TensorOptions(torch::kFloat64);
+            auto idx = torch::arange(-width, width + orig, options).view({1, 1, -1}) / orig;
+            auto t = (torch::arange(0, -target, -1, options).view({-1, 1, 1}) / target + idx) * baseFreq;
+            t = t.clamp(-lowpassFilterWidth, lowpassFilterWidth);
+
+            auto window = torch::cos(t * pi / lowpassFilterWidth / 2).pow(2);
+            t = t * pi;
+            auto kernel = torch::where(t == 0, torch::ones_like(t), torch::sin(t) / t) * window * (baseFreq / orig);
+
+            auto shape = signal.sizes().vec();
+            auto length = shape.back();
+            auto waveform = signal.reshape({-1, 1, length});
+            waveform = F::pad(waveform, F::PadFuncOptions({width, width + orig}));
+
+            auto resampled = F::conv1d(waveform, kernel.to(signal.scalar_type()).to(signal.device()), F::Conv1dFuncOptions().stride(orig));
+            resampled = resampled.transpose(1, 2).reshape({waveform.size(0), -1});
+
+            auto targetLength = int64_t(std::ceil(double(target) * length / orig));
+            shape.back() = targetLength;
+            return resampled.narrow(1, 0, targetLength).reshape(shape);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <napi.h>
+
+#include <memory>
+#include <string>
+#include <torch/torch.h>
+
+namespace nodeml_torch
+{
+    namespace audio
+    {
+        // Defaults follow torchaudio.transforms
+        struct SpectrogramOptions
+        {
+            int64_t nFft = 400;
+            int64_t winLength = 400;
+            int64_t hopLength = 200;
+            bool center = true;
+            // 0 returns the complex result as [..., 2]
+            double power = 2.0;
+            std::string window = "hann";
+        };
+
+        struct MelOptions
+        {
+            SpectrogramOptions spectrogram;
+            int64_t sampleRate = 16000;
+            int64_t nMels = 128;
+            double fMin = 0.0;
+            // 0 means sampleRate / 2
+            double fMax = 0.0;
+            bool log = false;
+        };
+
+        // A Float32Array is viewed in place, keepAlive pins it until the work that reads it has finished
+        struct Signal
+        {
+            torch::Tensor samples;
+            std::shared_ptr<Napi::Reference<Napi::Float32Array>> keepAlive;
+        };
+
+        Signal signalFromValue(const Napi::Value &value);
+
+        SpectrogramOptions spectrogramOptionsFromObject(const Napi::Object &obj);
+
+        MelOptions melOptionsFromObject(const Napi::Object &obj);
+
+        torch::Tensor computeSpectrogram(const torch::Tensor &signal, const SpectrogramOptions &options);
+
+        // Triangular HTK mel filters, [nFft / 2 + 1, nMels]
+        torch::Tensor melFilterbank(const MelOptions &options);
+
+        torch::Tensor computeMelSpectrogram(const torch::Tensor &signal, const MelOptions &options, const torch::Tensor &filterbank);
+
+        // Orthonormal DCT-II, [nMels, nMfcc]
+        torch::Tensor dctMatrix(int64_t nMfcc, int64_t nMels);
+
+        torch::Tensor computeMfcc(const torch::Tensor &signal, const MelOptions &options, int64_t nMfcc, double topDb);
+
+        // Windowed sinc interpolation, as torchaudio.functional.resample
+        torch::Tensor resampleSignal(const torch::Tensor &signal, int64_t origFreq, int64_t newFreq, int64_t lowpassFilterWidth, double rolloff);
+    }
+}
@@ -0,0 +1,523 @@
+#include <addon/data/ImageFolderLoader.hpp>
+#include <addon/Tensor.hpp>
+#include <addon/utils.hpp>
+#include <addon/vision/ops.hpp>
+#include <torchvision/vision.h>
+#include <torchvision/io/image/image.h>
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <random>
+
+namespace torchvision_io = vision::image;
+namespace nodeml_torch
+{
+    namespace data
+    {
+        namespace fs = std::filesystem;
+
+        static bool isImageFile(const fs::path &path)
+        {
+            auto extension = path.extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c)
+                           { return std::tolower(c); });
+            return extension == ".jpg" || extension == ".jpeg" || extension == ".png";
+        }
+
+        // Images inside a sub directory of the root are labelled with that directory, like torchvision's ImageFolder
+        static void scanRoot(LoaderState &state)
+        {
+            fs::path root(state.root);
+            std::vector<std::pair<std::string, std::string>> found;
+
+            for (auto &entry : fs::recursive_directory_iterator(root, fs::directory_options::skip_permission_denied))
+            {
+                if (state.stopped)
+                {
+                    return;
+                }
+
+                if (!entry.is_regular_file() || !isImageFile(entry.path()))
+                {
+                    continue;
+                }
+
+                auto relative = entry.path().lexically_relative(root);
+                auto className = std::distance(relative.begin(), relative.end()) > 1 ? relative.begin()->string() : std::string();
+                found.emplace_back(entry.path().string(), className);
+            }
+
+            std::sort(found.begin(), found.end());
+
+            for (auto &[path, className] : found)
+            {
+                if (!className.empty())
+                {
+                    state.classes.push_back(className);
+                }
+            }
+            std::sort(state.classes.begin(), state.classes.end());
+            state.classes.erase(std::unique(state.classes.begin(), state.classes.end()), state.classes.end());
+
+            for (auto &[path, className] : found)
+            {
+                state.paths.push_back(path);
+                state.labels.push_back(className.empty() ? -1 : std::lower_bound(state.classes.begin(), state.classes.end(), className) - state.classes.begin());
+            }
+
+            state.order.resize(state.paths.size());
+            for (size_t i = 0; i < state.order.size(); i++)
+            {
+                state.order[i] = i;
+            }
+
+            if (state.shuffle)
+            {
+                std::shuffle(state.order.begin(), state.order.end(), std::mt19937_64(state.seed));
+            }
+
+            state.numBatches = (state.paths.size() + state.batchSize - 1) / state.batchSize;
+        }
+
+        static torch::Tensor loadImage(const std::string &path, const ImageTransform &transform)
+        {
+            auto image = torchvision_io::decode_image(torchvision_io::read_file(path), torchvision_io::IMAGE_READ_MODE_RGB);
+
+            if (transform.letterbox)
+            {
+                image = std::get<0>(vision::ops::letterboxImage(image, transform.height, transform.width, 114, 0, true));
+            }
+            else if (image.size(1) != transform.height || image.size(2) != transform.width)
+            {
+                auto options = torch::nn::functional::InterpolateFuncOptions()
+                                   .size(std::vector<int64_t>({transform.height, transform.width}))
+                                   .mode(torch::kBilinear)
+                                   .align_corners(false)
+                                   .antialias(true);
+
+                image = torch::nn::functional::interpolate(image.unsqueeze(0).to(torch::kFloat), options).squeeze(0);
+            }
+
+            if (!transform.toFloat)
+            {
+                return image.is_floating_point() ? image.round().clamp(0, 255).to(torch::kUInt8) : image;
+            }
+
+            image = image.to(torch::kFloat).div(255);
+
+            if (!transform.mean.empty())
+            {
+                image = image.sub(torch::tensor(transform.mean, torch::kFloat).view({-1, 1, 1}));
+            }
+
+            if (!transform.std.empty())
+            {
+                image = image.div(torch::tensor(transform.std, torch::kFloat).view({-1, 1, 1}));
+            }
+
+            return image;
+        }
+
+        static std::shared_ptr<ImageBatch> loadBatch(LoaderState &state, size_t index)
+        {
+            auto start = index * state.batchSize;
+            auto end = std::min(start + state.batchSize, state.paths.size());
+            auto batch = std::make_shared<ImageBatch>();
+
+            std::vector<torch::Tensor> images;
+            std::vector<int64_t> labels;
+
+            for (auto i = start; i < end; i++)
+            {
+                auto item = state.order.at(i);
+                images.push_back(loadImage(state.paths.at(item), state.transform));
+                labels.push_back(state.labels.at(item));
+                batch->paths.push_back(state.paths.at(item));
+            }
+
+            // Written straight into the target layout instead of restriding the stacked batch
+            auto &first = images.front();
+            batch->images = torch::empty({int64_t(images.size()), first.size(0), first.size(1), first.size(2)},
+                                         first.options().memory_format(state.transform.memoryFormat));
+            for (size_t i = 0; i < images.size(); i++)
+            {
+                batch->images[int64_t(i)].copy_(images[i]);
+            }
+            batch->labels = torch::tensor(labels, torch::kLong);
+
+            return batch;
+        }
+
+        static Napi::Value batchToObject(Napi::Env env, const std::shared_ptr<ImageBatch> &batch)
+        {
+            if (!batch)
+            {
+                return env.Null();
+            }
+
+            auto paths = Napi::Array::New(env, batch->paths.size());
+            for (size_t i = 0; i < batch->paths.size(); i++)
+            {
+                paths.Set(uint32_t(i), batch->paths.at(i));
+            }
+
+            auto result = Napi::Object::New(env);
+            result.Set("images", Tensor::FromTorchTensor(env, batch->images));
+            result.Set("labels", Tensor::FromTorchTensor(env, batch->labels));
+            result.Set("paths", paths);
+            return result;
+        }
+
+        // Hands out batches strictly by index so numWorkers does not change the order, JS thread only
+        static void settlePending(Napi::Env env, LoaderState &state)
+        {
+            std::vector<std::pair<Napi::Promise::Deferred, std::shared_ptr<ImageBatch>>> resolved;
+            std::vector<Napi::Promise::Deferred> rejected;
+            std::string error;
+
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                error = state.error;
+
+                while (!state.pending.empty())
+                {
+                    auto found = state.ready.find(state.nextHanded);
+                    auto finished = state.stopped || (state.scanned && state.finishedWorkers == state.workers.size());
+
+                    if (!error.empty())
+                    {
+                        rejected.push_back(state.pending.front());
+                    }
+                    else if (found != state.ready.end())
+                    {
+                        resolved.emplace_back(state.pending.front(), found->second);
+                        state.ready.erase(found);
+                        state.nextHanded++;
+                        state.slotFree.notify_all();
+                    }
+                    else if (finished)
+                    {
+                        resolved.emplace_back(state.pending.front(), nullptr);
+                    }
+                    else
+                    {
+                        break;
+                    }
+
+                    state.pending.pop_front();
+                }
+            }
+
+            // Only waiting next() calls keep the process alive
+            if (state.pending.empty() && state.notifyReferenced)
+            {
+                state.notify.Unref(env);
+                state.notifyReferenced = false;
+            }
+
+            for (auto &deferred : rejected)
+            {
+                deferred.Reject(Napi::Error::New(env, error).Value());
+            }
+
+            for (auto &[deferred, batch] : resolved)
+            {
+                deferred.Resolve(batchToObject(env, batch));
+            }
+        }
+
+        // Wakes the JS thread to settle pending next() calls, the state may be gone by the time it runs
+        static void notifyWaiters(LoaderState &state)
+        {
+            auto weak = state.weak_from_this();
+            state.notify.NonBlockingCall([weak](Napi::Env env, Napi::Function)
+                                         {
+                                             if (auto locked = weak.lock())
+                                             {
+                                                 settlePending(env, *locked);
+                                             } });
+        }
+
+        static void workerLoop(LoaderState *state)
+        {
+            while (true)
+            {
+                size_t index;
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (state->stopped || state->nextBatch >= state->numBatches)
+                    {
+                        break;
+                    }
+                    index = state->nextBatch++;
+                }
+
+                std::shared_ptr<ImageBatch> batch;
+                try
+                {
+                    batch = loadBatch(*state, index);
+                }
+                catch (const std::exception &e)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        state->error = e.what();
+                        state->stopped = true;
+                        state->slotFree.notify_all();
+                    }
+                    notifyWaiters(*state);
+                    break;
+                }
+
+                // Bounded window, a worker ahead of the consumer by prefetch batches waits here until next() catches up.
+                // The batch next() wants is always inside the window, so the window cannot stall
+                {
+                    std::unique_lock<std::mutex> lock(state->mutex);
+                    state->slotFree.wait(lock, [&]()
+                                         { return index < state->nextHanded + state->prefetch || state->stopped; });
+                    if (state->stopped)
+                    {
+                        break;
+                    }
+                    state->ready.emplace(index, batch);
+                }
+                notifyWaiters(*state);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finishedWorkers++;
+            }
+            notifyWaiters(*state);
+        }
+
+        Napi::Object ImageFolderLoader::Init(Napi::Env env, Napi::Object exports)
+        {
+            auto func = DefineClass(env, "ImageFolderLoader",
+                                    {
+                                        ImageFolderLoader::InstanceMethod("next", &ImageFolderLoader::Next),
+                                        ImageFolderLoader::InstanceMethod("close", &ImageFolderLoader::Close),
+                                        ImageFolderLoader::InstanceAccessor("classes", &ImageFolderLoader::Classes, nullptr),
+                                        ImageFolderLoader::InstanceAccessor("size", &ImageFolderLoader::Size, nullptr),
+                                    });
+
+            exports.Set("ImageFolderLoader", func);
+            return exports;
+        }
+
+        ImageFolderLoader::ImageFolderLoader(const Napi::CallbackInfo &info) : ObjectWrap(info)
+        {
+            auto env = info.Env();
+
+            if (info.Length() < 1 || !info[0].IsObject() || !info[0].ToObject().Has("root"))
+            {
+                throw Napi::Error::New(env, "ImageFolderLoader requires a root directory");
+            }
+
+            auto options = info[0].ToObject();
+
+            state = std::make_shared<LoaderState>();
+            state->root = options.Get("root").ToString().Utf8Value();
+            state->numWorkers = std::max<int64_t>(1, std::thread::hardware_concurrency());
+            state->seed = std::random_device()();
+
+            if (options.Has("batchSize"))
+            {
+                state->batchSize = std::max<int64_t>(1, options.Get("batchSize").ToNumber().Int64Value());
+            }
+
+            if (options.Has("shuffle"))
+            {
+                state->shuffle = options.Get("shuffle").ToBoolean().Value();
+            }
+
+            if (options.Has("seed"))
+            {
+                state->seed = options.Get("seed").ToNumber().Int64Value();
+            }
+
+            if (options.Has("numWorkers"))
+            {
+                state->numWorkers = std::max<int64_t>(1, options.Get("numWorkers").ToNumber().Int64Value());
+            }
+
+            if (options.Has("prefetch"))
+            {
+                state->prefetch = std::max<int64_t>(1, options.Get("prefetch").ToNumber().Int64Value());
+            }
+
+            if (options.Has("transform") && options.Get("transform").IsObject())
+            {
+                auto transform = options.Get("transform").ToObject();
+
+                if (transform.Has("size"))
+                {
+                    auto size = transform.Get("size");
+                    if (size.IsArray())
+                    {
+                        auto sizes = utils::napiArrayToVector<int64_t>(size.As<Napi::Array>());
+                        state->transform.height = sizes.at(0);
+                        state->transform.width = sizes.at(1);
+                    }
+                    else
+                    {
+                        state->transform.height = state->transform.width = size.ToNumber().Int64Value();
+                    }
+                }
+
+                if (transform.Has("letterbox"))
+                {
+                    state->transform.letterbox = transform.Get("letterbox").ToBoolean().Value();
+                }
+
+                if (transform.Has("dtype"))
+                {
+                    state->transform.toFloat = utils::stringToScalarType(transform.Get("dtype").ToString().Utf8Value()) != torch::kUInt8;
+                }
+
+                if (transform.Has("mean"))
+                {
+                    state->transform.mean = utils::napiArrayToVector<double>(transform.Get("mean").As<Napi::Array>());
+                }
+
+                if (transform.Has("std"))
+                {
+                    state->transform.std = utils::napiArrayToVector<double>(transform.Get("std").As<Napi::Array>());
+                }
+
+                if (transform.Has("memoryFormat"))
+                {
+                    // Batches are 4d, anything else would only fail later inside a decode thread
+                    auto format = transform.Get("memoryFormat").ToString().Utf8Value();
+                    if (format != "contiguous" && format != "channelsLast")
+                    {
+                        throw Napi::Error::New(env, "transform.memoryFormat must be 'contiguous' or 'channelsLast'");
+                    }
+                    state->transform.memoryFormat = utils::stringToMemoryFormat(format);
+                }
+            }
+
+            state->notify = Napi::ThreadSafeFunction::New(env, Napi::Function(), "nodeml_torch.ImageFolderLoader", 0, 1);
+            state->notify.Unref(env);
+
+            // Walking a large tree can take a while, so it happens on the scanner thread which then starts the decoders
+            auto raw = state.get();
+            state->scanner = std::thread([raw]()
+                                         {
+                                             try
+                                             {
+                                                 scanRoot(*raw);
+                                             }
+                                             catch (const std::exception &e)
+                                             {
+                                                 std::lock_guard<std::mutex> lock(raw->mutex);
+                                                 raw->error = e.what();
+                                             }
+
+                                             {
+                                                 std::lock_guard<std::mutex> lock(raw->mutex);
+                                                 raw->scanned = true;
+                                                 if (raw->error.empty() && !raw->stopped)
+                                                 {
+                                                     for (int64_t i = 0; i < raw->numWorkers; i++)
+                                                     {
+                                                         raw->workers.emplace_back(workerLoop, raw);
+                                                     }
+                                                 }
+                                             }
+                                             notifyWaiters(*raw); });
+        }
+
+        ImageFolderLoader::~ImageFolderLoader()
+        {
+            Stop();
+
+            // Notifications still queued find nothing to settle once the wrapper is gone
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->pending.clear();
+            }
+            state->notifyReferenced = false;
+            state->notify.Release();
+        }
+
+        void ImageFolderLoader::Stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->stopped = true;
+            }
+
+            state->slotFree.notify_all();
+
+            if (state->scanner.joinable())
+            {
+                state->scanner.join();
+            }
+
+            for (auto &worker : state->workers)
+            {
+                if (worker.joinable())
+                {
+                    worker.join();
+                }
+            }
+        }
+
+        // Never parks a threadpool thread, the promise is settled once its batch has been produced
+        Napi::Value ImageFolderLoader::Next(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto deferred = Napi::Promise::Deferred::New(env);
+
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->pending.push_back(deferred);
+                }
+
+                if (!state->notifyReferenced)
+                {
+                    state->notify.Ref(env);
+                    state->notifyReferenced = true;
+                }
+
+                settlePending(env, *state);
+                return deferred.Promise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value ImageFolderLoader::Close(const Napi::CallbackInfo &info)
+        {
+            Stop();
+            settlePending(info.Env(), *state);
+            return Napi::Value();
+        }
+
+        Napi::Value ImageFolderLoader::Classes(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            std::lock_guard<std::mutex> lock(state->mutex);
+
+            auto result = Napi::Array::New(env, state->scanned ? state->classes.size() : 0);
+            for (uint32_t i = 0; i < result.Length(); i++)
+            {
+                result.Set(i, state->classes.at(i));
+            }
+
+            return result;
+        }
+
+        Napi::Value ImageFolderLoader::Size(const Napi::CallbackInfo &info)
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            return Napi::Number::New(info.Env(), state->scanned ? double(state->paths.size()) : 0);
+        }
+    }
+}
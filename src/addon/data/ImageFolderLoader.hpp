@@ -0,0 +1,96 @@
+#pragma once
+
+#include <napi.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <torch/torch.h>
+
+namespace nodeml_torch
+{
+    namespace data
+    {
+        struct ImageBatch
+        {
+            torch::Tensor images;
+            torch::Tensor labels;
+            std::vector<std::string> paths;
+        };
+
+        struct ImageTransform
+        {
+            int64_t height = 224;
+            int64_t width = 224;
+            bool letterbox = false;
+            bool toFloat = true;
+            std::vector<double> mean;
+            std::vector<double> std;
+            // channelsLast batches keep the NCHW shape with NHWC strides
+            torch::MemoryFormat memoryFormat = torch::MemoryFormat::Contiguous;
+        };
+
+        // Shared between the JS object, the decode threads and pending next() calls
+        struct LoaderState : std::enable_shared_from_this<LoaderState>
+        {
+            std::string root;
+            int64_t batchSize = 32;
+            int64_t numWorkers = 4;
+            size_t prefetch = 2;
+            bool shuffle = false;
+            uint64_t seed = 0;
+            ImageTransform transform;
+
+            std::vector<std::string> paths;
+            std::vector<int64_t> labels;
+            std::vector<std::string> classes;
+            std::vector<size_t> order;
+            size_t numBatches = 0;
+            size_t nextBatch = 0;
+            // Index of the next batch handed to next(), batches finishing early wait in ready
+            size_t nextHanded = 0;
+
+            std::mutex mutex;
+            std::condition_variable slotFree;
+            std::map<size_t, std::shared_ptr<ImageBatch>> ready;
+            // next() promises, settled on the JS thread whenever a producer calls notify
+            std::deque<Napi::Promise::Deferred> pending;
+            Napi::ThreadSafeFunction notify;
+            bool notifyReferenced = false;
+            std::thread scanner;
+            std::vector<std::thread> workers;
+            bool scanned = false;
+            size_t finishedWorkers = 0;
+            std::atomic<bool> stopped{false};
+            std::string error;
+        };
+
+        class ImageFolderLoader : public Napi::ObjectWrap<ImageFolderLoader>
+        {
+
+        public:
+            std::shared_ptr<LoaderState> state;
+
+            static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+            ImageFolderLoader(const Napi::CallbackInfo &info);
+
+            ~ImageFolderLoader();
+
+            Napi::Value Next(const Napi::CallbackInfo &info);
+
+            Napi::Value Close(const Napi::CallbackInfo &info);
+
+            Napi::Value Classes(const Napi::CallbackInfo &info);
+
+            Napi::Value Size(const Napi::CallbackInfo &info);
+
+            void Stop();
+        };
+    }
+}
@@ -0,0 +1,19 @@
+#include <addon/data/data.hpp>
+#include <addon/data/ImageFolderLoader.hpp>
+
+namespace nodeml_torch
+{
+    namespace data
+    {
+        Napi::Object Init(Napi::Env env, Napi::Object exports)
+        {
+            auto myExports = Napi::Object::New(env);
+
+            ImageFolderLoader::Init(env, myExports);
+
+            exports.Set("data", myExports);
+
+            return exports;
+        }
+    }
+}
@@ -1,5 +1,7 @@
 #include <napi.h>
+#include <addon/AddonData.hpp>
 #include <addon/Tensor.hpp>
+#include <addon/Generator.hpp>
 #include <addon/utils.hpp>
 #include <addon/types.hpp>
 #include <addon/aten.hpp>
@@ -7,10 +9,19 @@
 #include <addon/jit/jit.hpp>
 #include <addon/vision/vision.hpp>
 #include <addon/cuda/cuda.hpp>
+#include <addon/data/data.hpp>
+#include <addon/memory/memory.hpp>
+#include <addon/index/index.hpp>
+#include <addon/audio/audio.hpp>
+#include <addon/shm/shm.hpp>
+#include <addon/safetensors/safetensors.hpp>
+#include <addon/numpy/numpy.hpp>
 
 Napi::Object InitModule(Napi::Env env, Napi::Object exports)
 {
+    nodeml_torch::AddonData::Create(env);
     nodeml_torch::Tensor::Init(env, exports);
+    nodeml_torch::Generator::Init(env, exports);
     nodeml_torch::utils::Init(env, exports);
     nodeml_torch::types::Init(env, exports);
     nodeml_torch::aten::Init(env, exports);
@@ -18,6 +29,13 @@ Napi::Object InitModule(Napi::Env env, Napi::Object exports)
     nodeml_torch::jit::Init(env, exports);
     nodeml_torch::vision::Init(env, exports);
     nodeml_torch::cuda::Init(env,exports);
+    nodeml_torch::data::Init(env, exports);
+    nodeml_torch::memory::Init(env, exports);
+    nodeml_torch::index::Init(env, exports);
+    nodeml_torch::audio::Init(env, exports);
+    nodeml_torch::shm::Init(env, exports);
+    nodeml_torch::safetensors::Init(env, exports);
+    nodeml_torch::numpy::Init(env, exports);
     return exports;
 }
 
@@ -0,0 +1,304 @@
+#include <addon/index/FlatIndex.hpp>
+#include <addon/AddonData.hpp>
+#include <addon/index/index.hpp>
+#include <addon/FunctionWorker.hpp>
+#include <addon/Tensor.hpp>
+#include <addon/utils.hpp>
+
+#include <mutex>
+
+namespace nodeml_torch
+{
+    namespace index
+    {
+        torch::Tensor idsFromValue(const Napi::Value &value)
+        {
+            if (value.IsArray())
+            {
+                return torch::tensor(utils::napiArrayToVector<int64_t>(value.As<Napi::Array>()), torch::TensorOptions(torch::kLong));
+            }
+
+            return Tensor::FromObject(value)->torchTensor.to(torch::kLong).flatten().contiguous();
+        }
+
+        torch::Tensor assignIds(const Napi::Value &value, int64_t count, int64_t &nextId)
+        {
+            if (value.IsUndefined() || value.IsNull())
+            {
+                auto ids = torch::arange(nextId, nextId + count, torch::TensorOptions(torch::kLong));
+                nextId += count;
+                return ids;
+            }
+
+            auto ids = idsFromValue(value);
+            if (ids.numel() != count)
+            {
+                throw std::invalid_argument("Expected one id per vector");
+            }
+
+            if (count > 0)
+            {
+                nextId = std::max(nextId, ids.max().item<int64_t>() + 1);
+            }
+
+            return ids;
+        }
+
+        Napi::Object searchResultToObject(Napi::Env env, const std::tuple<torch::Tensor, torch::Tensor> &result, Metric metric)
+        {
+            auto object = Napi::Object::New(env);
+            object.Set("distances", Tensor::FromTorchTensor(env, scoresToDistances(std::get<0>(result), metric)));
+            object.Set("ids", Tensor::FromTorchTensor(env, std::get<1>(result)));
+            return object;
+        }
+
+        Napi::Object FlatIndex::Init(Napi::Env env, Napi::Object exports)
+        {
+            auto func = DefineClass(env, "FlatIndex",
+                                    {
+                                        FlatIndex::InstanceMethod("add", &FlatIndex::Add),
+                                        FlatIndex::InstanceMethod("remove", &FlatIndex::Remove),
+                                        FlatIndex::InstanceMethod("search", &FlatIndex::Search),
+                                        FlatIndex::InstanceMethod("save", &FlatIndex::Save),
+                                        FlatIndex::InstanceAccessor("size", &FlatIndex::Size, nullptr),
+                                        FlatIndex::InstanceAccessor("dim", &FlatIndex::Dim, nullptr),
+                                        FlatIndex::InstanceAccessor("metric", &FlatIndex::MetricName, nullptr),
+                                    });
+
+            AddonData::Get(env)->flatIndexConstructor = Napi::Persistent(func);
+            exports.Set("FlatIndex", func);
+            return exports;
+        }
+
+        Napi::Object FlatIndex::FromState(Napi::Env env, const std::shared_ptr<FlatState> &state)
+        {
+            Napi::EscapableHandleScope scope(env);
+            auto object = AddonData::Get(env)->flatIndexConstructor.New({});
+            Napi::ObjectWrap<FlatIndex>::Unwrap(object)->state = state;
+            return scope.Escape(object).ToObject();
+        }
+
+        std::vector<torch::Tensor> FlatIndex::ToTensors(FlatState &state)
+        {
+            auto meta = torch::tensor({indexFormatVersion, int64_t(IndexKind::Flat), state.store.dim, int64_t(state.metric), state.nextId},
+                                      torch::TensorOptions(torch::kLong));
+            return {meta, state.store.activeVectors().clone(), state.store.activeIds().clone()};
+        }
+
+        std::shared_ptr<FlatState> FlatIndex::FromTensors(const std::vector<torch::Tensor> &tensors)
+        {
+            if (tensors.size() != 3 || tensors[0].numel() < 5)
+            {
+                throw std::runtime_error("Saved flat index is incomplete");
+            }
+
+            auto meta = tensors[0].to(torch::kLong);
+            auto state = std::make_shared<FlatState>();
+            state->store.dim = meta[2].item<int64_t>();
+            state->metric = metricFromCode(meta[3].item<int64_t>());
+            state->nextId = meta[4].item<int64_t>();
+
+            if (state->store.dim <= 0)
+            {
+                throw std::runtime_error("Saved flat index has an invalid dim");
+            }
+
+            checkSavedRows(tensors[1], tensors[2], state->store.dim);
+            state->store.dtype = tensors[1].scalar_type();
+            state->store.append(tensors[1], tensors[2], state->metric);
+            return state;
+        }
+
+        FlatIndex::FlatIndex(const Napi::CallbackInfo &info) : ObjectWrap(info)
+        {
+            auto env = info.Env();
+            state = std::make_shared<FlatState>();
+
+            // FromState creates the object without options and fills in the state afterwards
+            if (info.Length() == 0)
+            {
+                return;
+            }
+
+            if (!info[0].IsObject() || !info[0].ToObject().Has("dim"))
+            {
+                throw Napi::Error::New(env, "FlatIndex requires a vector dim");
+            }
+
+            auto options = info[0].ToObject();
+
+            try
+            {
+                state->store.dim = options.Get("dim").ToNumber().Int64Value();
+
+                if (options.Has("metric"))
+                {
+                    state->metric = metricFromString(options.Get("metric").ToString().Utf8Value());
+                }
+
+                if (options.Has("dtype"))
+                {
+                    state->store.dtype = utils::stringToScalarType(options.Get("dtype").ToString().Utf8Value());
+                }
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value FlatIndex::Add(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto vectors = Tensor::FromObject(info[0])->torchTensor;
+                auto idsValue = info.Length() > 1 ? info[1] : env.Undefined();
+                auto state = this->state;
+
+                // Ids are assigned up front so concurrent adds never hand out the same auto id
+                torch::Tensor ids;
+                {
+                    std::unique_lock<std::shared_mutex> lock(state->mutex);
+                    ids = assignIds(idsValue, vectors.dim() == 1 ? 1 : vectors.size(0), state->nextId);
+                }
+
+                auto worker = new FunctionWorker<torch::Tensor>(
+                    env,
+                    [=]() -> torch::Tensor
+                    {
+                        torch::NoGradGuard no_grad;
+                        auto rows = prepareVectors(vectors, state->store.dim, state->store.dtype, state->metric);
+
+                        std::unique_lock<std::shared_mutex> lock(state->mutex);
+                        state->store.append(rows, ids, state->metric);
+                        return ids;
+                    },
+                    [=](Napi::Env env, torch::Tensor value) -> Napi::Value
+                    {
+                        return Tensor::FromTorchTensor(env, value);
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value FlatIndex::Remove(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto ids = idsFromValue(info[0]);
+                auto state = this->state;
+
+                auto worker = new FunctionWorker<int64_t>(
+                    env,
+                    [=]() -> int64_t
+                    {
+                        std::unique_lock<std::shared_mutex> lock(state->mutex);
+                        return state->store.remove(ids);
+                    },
+                    [=](Napi::Env env, int64_t value) -> Napi::Value
+                    {
+                        return Napi::Number::New(env, double(value));
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value FlatIndex::Search(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto queries = Tensor::FromObject(info[0])->torchTensor;
+                auto k = info.Length() > 1 ? std::max<int64_t>(1, info[1].ToNumber().Int64Value()) : 10;
+                auto state = this->state;
+
+                auto worker = new FunctionWorker<std::tuple<torch::Tensor, torch::Tensor>>(
+                    env,
+                    [=]() -> std::tuple<torch::Tensor, torch::Tensor>
+                    {
+                        torch::NoGradGuard no_grad;
+                        auto rows = prepareVectors(queries, state->store.dim, state->store.dtype, state->metric);
+
+                        std::shared_lock<std::shared_mutex> lock(state->mutex);
+                        return state->store.search(rows, k, state->metric);
+                    },
+                    [=](Napi::Env env, std::tuple<torch::Tensor, torch::Tensor> value) -> Napi::Value
+                    {
+                        return searchResultToObject(env, value, state->metric);
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value FlatIndex::Save(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto path = info[0].ToString().Utf8Value();
+                auto state = this->state;
+
+                auto worker = new FunctionWorker<bool>(
+                    env,
+                    [=]() -> bool
+                    {
+                        std::vector<torch::Tensor> tensors;
+                        {
+                            std::shared_lock<std::shared_mutex> lock(state->mutex);
+                            tensors = ToTensors(*state);
+                        }
+
+                        torch::save(tensors, path);
+                        return true;
+                    },
+                    [=](Napi::Env env, bool value) -> Napi::Value
+                    {
+                        return env.Undefined();
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value FlatIndex::Size(const Napi::CallbackInfo &info)
+        {
+            std::shared_lock<std::shared_mutex> lock(state->mutex);
+            return Napi::Number::New(info.Env(), double(state->store.count));
+        }
+
+        Napi::Value FlatIndex::Dim(const Napi::CallbackInfo &info)
+        {
+            return Napi::Number::New(info.Env(), double(state->store.dim));
+        }
+
+        Napi::Value FlatIndex::MetricName(const Napi::CallbackInfo &info)
+        {
+            return Napi::String::New(info.Env(), metricToString(state->metric));
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <napi.h>
+
+#include <addon/index/VectorStore.hpp>
+#include <memory>
+#include <shared_mutex>
+
+namespace nodeml_torch
+{
+    namespace index
+    {
+        struct FlatState
+        {
+            // Searches share the lock, adds and removes take it exclusively
+            std::shared_mutex mutex;
+            Metric metric = Metric::InnerProduct;
+            VectorStore store;
+            int64_t nextId = 0;
+        };
+
+        // Ids for new rows, either given by the caller or counted up from nextId
+        torch::Tensor assignIds(const Napi::Value &value, int64_t count, int64_t &nextId);
+
+        torch::Tensor idsFromValue(const Napi::Value &value);
+
+        Napi::Object searchResultToObject(Napi::Env env, const std::tuple<torch::Tensor, torch::Tensor> &result, Metric metric);
+
+        class FlatIndex : public Napi::ObjectWrap<FlatIndex>
+        {
+
+        public:
+            std::shared_ptr<FlatState> state;
+
+            static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+            static Napi::Object FromState(Napi::Env env, const std::shared_ptr<FlatState> &state);
+
+            // Appends the state as [meta, vectors, ids] for torch::save
+            static std::vector<torch::Tensor> ToTensors(FlatState &state);
+
+            static std::shared_ptr<FlatState> FromTensors(const std::vector<torch::Tensor> &tensors);
+
+            FlatIndex(const Napi::CallbackInfo &info);
+
+            Napi::Value Add(const Napi::CallbackInfo &info);
+
+            Napi::Value Remove(const Napi::CallbackInfo &info);
+
+            Napi::Value Search(const Napi::CallbackInfo &info);
+
+            Napi::Value Save(const Napi::CallbackInfo &info);
+
+            Napi::Value Size(const Napi::CallbackInfo &info);
+
+            Napi::Value Dim(const Napi::CallbackInfo &info);
+
+            Napi::Value MetricName(const Napi::CallbackInfo &info);
+        };
+    }
+}
@@ -0,0 +1,529 @@
+#include <addon/index/IVFIndex.hpp>
+#include <addon/AddonData.hpp>
+#include <addon/index/FlatIndex.hpp>
+#include <addon/index/index.hpp>
+#include <addon/FunctionWorker.hpp>
+#include <addon/Tensor.hpp>
+#include <addon/sampling.hpp>
+#include <addon/utils.hpp>
+
+#include <limits>
+#include <mutex>
+
+namespace nodeml_torch
+{
+    namespace index
+    {
+        // k-means only looks at this many vectors per list, like faiss
+        static const int64_t trainingPointsPerList = 256;
+
+        // The n best centroids for each row, [rows, n]
+        static torch::Tensor nearestCentroids(const torch::Tensor &rows, const torch::Tensor &centroids, Metric metric, int64_t n)
+        {
+            auto scores = torch::matmul(rows, centroids.t());
+            if (metric == Metric::L2)
+            {
+                scores = scores * 2 - centroids.pow(2).sum(1).unsqueeze(0);
+            }
+
+            return std::get<1>(scores.topk(n, 1));
+        }
+
+        static torch::Tensor kmeans(const torch::Tensor &rows, int64_t nlist, Metric metric, int64_t iterations, uint64_t seed)
+        {
+            auto generator = sampling::makeGenerator(seed);
+            auto points = rows;
+
+            if (points.size(0) > nlist * trainingPointsPerList)
+            {
+                auto sample = torch::randperm(points.size(0), generator, torch::TensorOptions(torch::kLong)).narrow(0, 0, nlist * trainingPointsPerList);
+                points = points.index_select(0, sample);
+            }
+
+            auto initial = torch::randperm(points.size(0), generator, torch::TensorOptions(torch::kLong)).narrow(0, 0, nlist);
+            auto centroids = points.index_select(0, initial).clone();
+
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                auto assignment = nearestCentroids(points, centroids, metric, 1).squeeze(1);
+                auto sums = torch::zeros_like(centroids).index_add_(0, assignment, points);
+                auto counts = torch::bincount(assignment, {}, nlist).to(centroids.scalar_type()).unsqueeze(1);
+
+                // Empty clusters keep their previous centroid
+                centroids = torch::where(counts > 0, sums / counts.clamp_min(1), centroids);
+
+                if (metric == Metric::Cosine)
+                {
+                    centroids = torch::nn::functional::normalize(centroids, torch::nn::functional::NormalizeFuncOptions().dim(1));
+                }
+            }
+
+            return centroids;
+        }
+
+        // Called with the state locked exclusively
+        static void addToLists(IVFState &state, const torch::Tensor &rows, const torch::Tensor &ids)
+        {
+            if (rows.size(0) == 0)
+            {
+                return;
+            }
+
+            auto assignment = nearestCentroids(rows, state.centroids, state.metric, 1).squeeze(1);
+            auto order = assignment.argsort();
+            auto counts = torch::bincount(assignment, {}, state.nlist).contiguous();
+            auto countsPtr = counts.data_ptr<int64_t>();
+
+            int64_t offset = 0;
+            for (int64_t list = 0; list < state.nlist; list++)
+            {
+                if (countsPtr[list] == 0)
+                {
+                    continue;
+                }
+
+                auto members = order.narrow(0, offset, countsPtr[list]);
+                state.lists[list].append(rows.index_select(0, members), ids.index_select(0, members), state.metric);
+                offset += countsPtr[list];
+            }
+        }
+
+        Napi::Object IVFIndex::Init(Napi::Env env, Napi::Object exports)
+        {
+            auto func = DefineClass(env, "IVFIndex",
+                                    {
+                                        IVFIndex::InstanceMethod("train", &IVFIndex::Train),
+                                        IVFIndex::InstanceMethod("add", &IVFIndex::Add),
+                                        IVFIndex::InstanceMethod("remove", &IVFIndex::Remove),
+                                        IVFIndex::InstanceMethod("search", &IVFIndex::Search),
+                                        IVFIndex::InstanceMethod("save", &IVFIndex::Save),
+                                        IVFIndex::InstanceAccessor("size", &IVFIndex::Size, nullptr),
+                                        IVFIndex::InstanceAccessor("dim", &IVFIndex::Dim, nullptr),
+                                        IVFIndex::InstanceAccessor("metric", &IVFIndex::MetricName, nullptr),
+                                        IVFIndex::InstanceAccessor("trained", &IVFIndex::Trained, nullptr),
+                                        IVFIndex::InstanceAccessor("nprobe", &IVFIndex::GetNprobe, &IVFIndex::SetNprobe),
+                                    });
+
+            AddonData::Get(env)->ivfIndexConstructor = Napi::Persistent(func);
+            exports.Set("IVFIndex", func);
+            return exports;
+        }
+
+        Napi::Object IVFIndex::FromState(Napi::Env env, const std::shared_ptr<IVFState> &state)
+        {
+            Napi::EscapableHandleScope scope(env);
+            auto object = AddonData::Get(env)->ivfIndexConstructor.New({});
+            Napi::ObjectWrap<IVFIndex>::Unwrap(object)->state = state;
+            return scope.Escape(object).ToObject();
+        }
+
+        std::vector<torch::Tensor> IVFIndex::ToTensors(IVFState &state)
+        {
+            auto trained = state.centroids.defined();
+            auto meta = torch::tensor({indexFormatVersion, int64_t(IndexKind::IVF), state.dim, int64_t(state.metric), state.nextId,
+                                       state.nlist, state.nprobe, int64_t(trained)},
+                                      torch::TensorOptions(torch::kLong));
+
+            std::vector<torch::Tensor> tensors = {meta, trained ? state.centroids.clone() : torch::empty({0, state.dim}, torch::TensorOptions(state.dtype))};
+            for (auto &list : state.lists)
+            {
+                tensors.push_back(list.activeVectors().clone());
+                tensors.push_back(list.activeIds().clone());
+            }
+
+            return tensors;
+        }
+
+        std::shared_ptr<IVFState> IVFIndex::FromTensors(const std::vector<torch::Tensor> &tensors)
+        {
+            if (tensors.size() < 2 || tensors[0].numel() < 8)
+            {
+                throw std::runtime_error("Saved IVF index is incomplete");
+            }
+
+            auto meta = tensors[0].to(torch::kLong);
+            auto state = std::make_shared<IVFState>();
+            state->dim = meta[2].item<int64_t>();
+            state->metric = metricFromCode(meta[3].item<int64_t>());
+            state->nextId = meta[4].item<int64_t>();
+            state->nlist = meta[5].item<int64_t>();
+            state->nprobe = meta[6].item<int64_t>();
+            state->dtype = tensors[1].scalar_type();
+
+            if (state->dim <= 0 || state->nlist <= 0 || state->nprobe <= 0)
+            {
+                throw std::runtime_error("Saved IVF index has an invalid dim, nlist or nprobe");
+            }
+
+            // Every list is saved as a vectors / ids pair after meta and centroids
+            if (int64_t(tensors.size() - 2) / 2 != state->nlist || tensors.size() % 2 != 0)
+            {
+                throw std::runtime_error("Saved IVF index has " + std::to_string((tensors.size() - 2) / 2) + " lists, expected nlist " +
+                                         std::to_string(state->nlist));
+            }
+
+            if (meta[7].item<int64_t>() != 0)
+            {
+                if (tensors[1].dim() != 2 || tensors[1].size(0) != state->nlist || tensors[1].size(1) != state->dim)
+                {
+                    throw std::runtime_error("Saved IVF centroids do not match nlist and dim");
+                }
+
+                state->centroids = tensors[1];
+            }
+
+            state->lists.resize(state->nlist);
+            for (int64_t list = 0; list < state->nlist; list++)
+            {
+                auto &vectors = tensors[2 + list * 2];
+                auto &ids = tensors[3 + list * 2];
+                checkSavedRows(vectors, ids, state->dim);
+
+                state->lists[list].dim = state->dim;
+                state->lists[list].dtype = state->dtype;
+                state->lists[list].append(vectors, ids, state->metric);
+            }
+
+            return state;
+        }
+
+        IVFIndex::IVFIndex(const Napi::CallbackInfo &info) : ObjectWrap(info)
+        {
+            auto env = info.Env();
+            state = std::make_shared<IVFState>();
+
+            // FromState creates the object without options and fills in the state afterwards
+            if (info.Length() == 0)
+            {
+                return;
+            }
+
+            if (!info[0].IsObject() || !info[0].ToObject().Has("dim"))
+            {
+                throw Napi::Error::New(env, "IVFIndex requires a vector dim");
+            }
+
+            auto options = info[0].ToObject();
+
+            try
+            {
+                state->dim = options.Get("dim").ToNumber().Int64Value();
+
+                if (options.Has("metric"))
+                {
+                    state->metric = metricFromString(options.Get("metric").ToString().Utf8Value());
+                }
+
+                if (options.Has("dtype"))
+                {
+                    state->dtype = utils::stringToScalarType(options.Get("dtype").ToString().Utf8Value());
+                }
+
+                if (options.Has("nlist"))
+                {
+                    state->nlist = std::max<int64_t>(1, options.Get("nlist").ToNumber().Int64Value());
+                }
+
+                if (options.Has("nprobe"))
+                {
+                    state->nprobe = std::max<int64_t>(1, options.Get("nprobe").ToNumber().Int64Value());
+                }
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+
+            state->lists.resize(state->nlist);
+            for (auto &list : state->lists)
+            {
+                list.dim = state->dim;
+                list.dtype = state->dtype;
+            }
+        }
+
+        Napi::Value IVFIndex::Train(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto vectors = Tensor::FromObject(info[0])->torchTensor;
+                int64_t iterations = 20;
+                uint64_t seed = 0;
+
+                if (info.Length() > 1 && info[1].IsObject())
+                {
+                    auto options = info[1].ToObject();
+
+                    if (options.Has("iterations"))
+                    {
+                        iterations = std::max<int64_t>(1, options.Get("iterations").ToNumber().Int64Value());
+                    }
+
+                    if (options.Has("seed"))
+                    {
+                        seed = uint64_t(options.Get("seed").ToNumber().Int64Value());
+                    }
+                }
+
+                auto state = this->state;
+
+                auto worker = new FunctionWorker<bool>(
+                    env,
+                    [=]() -> bool
+                    {
+                        torch::NoGradGuard no_grad;
+                        auto rows = prepareVectors(vectors, state->dim, state->dtype, state->metric);
+
+                        if (rows.size(0) < state->nlist)
+                        {
+                            throw std::invalid_argument("IVFIndex needs at least nlist training vectors");
+                        }
+
+                        auto centroids = kmeans(rows, state->nlist, state->metric, iterations, seed);
+
+                        // Vectors added under the previous centroids are redistributed over the new lists
+                        std::unique_lock<std::shared_mutex> lock(state->mutex);
+                        std::vector<torch::Tensor> existingVectors, existingIds;
+                        for (auto &list : state->lists)
+                        {
+                            existingVectors.push_back(list.activeVectors().clone());
+                            existingIds.push_back(list.activeIds().clone());
+                            list.count = 0;
+                        }
+
+                        state->centroids = centroids;
+                        addToLists(*state, torch::cat(existingVectors), torch::cat(existingIds));
+                        return true;
+                    },
+                    [=](Napi::Env env, bool value) -> Napi::Value
+                    {
+                        return env.Undefined();
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value IVFIndex::Add(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto vectors = Tensor::FromObject(info[0])->torchTensor;
+                auto idsValue = info.Length() > 1 ? info[1] : env.Undefined();
+                auto state = this->state;
+
+                torch::Tensor ids;
+                {
+                    std::unique_lock<std::shared_mutex> lock(state->mutex);
+                    if (!state->centroids.defined())
+                    {
+                        throw Napi::Error::New(env, "IVFIndex must be trained before adding vectors");
+                    }
+
+                    ids = assignIds(idsValue, vectors.dim() == 1 ? 1 : vectors.size(0), state->nextId);
+                }
+
+                auto worker = new FunctionWorker<torch::Tensor>(
+                    env,
+                    [=]() -> torch::Tensor
+                    {
+                        torch::NoGradGuard no_grad;
+                        auto rows = prepareVectors(vectors, state->dim, state->dtype, state->metric);
+
+                        std::unique_lock<std::shared_mutex> lock(state->mutex);
+                        addToLists(*state, rows, ids);
+                        return ids;
+                    },
+                    [=](Napi::Env env, torch::Tensor value) -> Napi::Value
+                    {
+                        return Tensor::FromTorchTensor(env, value);
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value IVFIndex::Remove(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto ids = idsFromValue(info[0]);
+                auto state = this->state;
+
+                auto worker = new FunctionWorker<int64_t>(
+                    env,
+                    [=]() -> int64_t
+                    {
+                        std::unique_lock<std::shared_mutex> lock(state->mutex);
+                        int64_t removed = 0;
+                        for (auto &list : state->lists)
+                        {
+                            removed += list.remove(ids);
+                        }
+                        return removed;
+                    },
+                    [=](Napi::Env env, int64_t value) -> Napi::Value
+                    {
+                        return Napi::Number::New(env, double(value));
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value IVFIndex::Search(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto queries = Tensor::FromObject(info[0])->torchTensor;
+                auto k = info.Length() > 1 ? std::max<int64_t>(1, info[1].ToNumber().Int64Value()) : 10;
+                auto state = this->state;
+
+                auto worker = new FunctionWorker<std::tuple<torch::Tensor, torch::Tensor>>(
+                    env,
+                    [=]() -> std::tuple<torch::Tensor, torch::Tensor>
+                    {
+                        torch::NoGradGuard no_grad;
+                        auto rows = prepareVectors(queries, state->dim, state->dtype, state->metric);
+
+                        std::shared_lock<std::shared_mutex> lock(state->mutex);
+                        if (!state->centroids.defined())
+                        {
+                            throw std::runtime_error("IVFIndex must be trained before searching");
+                        }
+
+                        auto numQueries = rows.size(0);
+                        auto bestScores = torch::full({numQueries, k}, -std::numeric_limits<double>::infinity(), torch::TensorOptions(torch::kFloat32));
+                        auto bestIds = torch::full({numQueries, k}, -1, torch::TensorOptions(torch::kLong));
+                        auto probes = nearestCentroids(rows, state->centroids, state->metric, std::min(state->nprobe, state->nlist));
+
+                        // Each list is scanned once for all of the queries that probe it
+                        for (int64_t list = 0; list < state->nlist; list++)
+                        {
+                            if (state->lists[list].count == 0)
+                            {
+                                continue;
+                            }
+
+                            auto queryIndex = (probes == list).any(1).nonzero().squeeze(1);
+                            if (queryIndex.numel() == 0)
+                            {
+                                continue;
+                            }
+
+                            auto [scores, ids] = state->lists[list].search(rows.index_select(0, queryIndex), k, state->metric);
+                            auto [mergedScores, mergedIds] = mergeTopK(bestScores.index_select(0, queryIndex), bestIds.index_select(0, queryIndex), scores, ids, k);
+                            bestScores.index_copy_(0, queryIndex, mergedScores);
+                            bestIds.index_copy_(0, queryIndex, mergedIds);
+                        }
+
+                        return {bestScores, bestIds};
+                    },
+                    [=](Napi::Env env, std::tuple<torch::Tensor, torch::Tensor> value) -> Napi::Value
+                    {
+                        return searchResultToObject(env, value, state->metric);
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value IVFIndex::Save(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto path = info[0].ToString().Utf8Value();
+                auto state = this->state;
+
+                auto worker = new FunctionWorker<bool>(
+                    env,
+                    [=]() -> bool
+                    {
+                        std::vector<torch::Tensor> tensors;
+                        {
+                            std::shared_lock<std::shared_mutex> lock(state->mutex);
+                            tensors = ToTensors(*state);
+                        }
+
+                        torch::save(tensors, path);
+                        return true;
+                    },
+                    [=](Napi::Env env, bool value) -> Napi::Value
+                    {
+                        return env.Undefined();
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value IVFIndex::Size(const Napi::CallbackInfo &info)
+        {
+            std::shared_lock<std::shared_mutex> lock(state->mutex);
+            int64_t size = 0;
+            for (auto &list : state->lists)
+            {
+                size += list.count;
+            }
+            return Napi::Number::New(info.Env(), double(size));
+        }
+
+        Napi::Value IVFIndex::Dim(const Napi::CallbackInfo &info)
+        {
+            return Napi::Number::New(info.Env(), double(state->dim));
+        }
+
+        Napi::Value IVFIndex::MetricName(const Napi::CallbackInfo &info)
+        {
+            return Napi::String::New(info.Env(), metricToString(state->metric));
+        }
+
+        Napi::Value IVFIndex::Trained(const Napi::CallbackInfo &info)
+        {
+            std::shared_lock<std::shared_mutex> lock(state->mutex);
+            return Napi::Boolean::New(info.Env(), state->centroids.defined());
+        }
+
+        Napi::Value IVFIndex::GetNprobe(const Napi::CallbackInfo &info)
+        {
+            std::shared_lock<std::shared_mutex> lock(state->mutex);
+            return Napi::Number::New(info.Env(), double(state->nprobe));
+        }
+
+        void IVFIndex::SetNprobe(const Napi::CallbackInfo &info, const Napi::Value &value)
+        {
+            std::unique_lock<std::shared_mutex> lock(state->mutex);
+            state->nprobe = std::max<int64_t>(1, value.ToNumber().Int64Value());
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <napi.h>
+
+#include <addon/index/VectorStore.hpp>
+#include <memory>
+#include <shared_mutex>
+
+namespace nodeml_torch
+{
+    namespace index
+    {
+        struct IVFState
+        {
+            std::shared_mutex mutex;
+            Metric metric = Metric::InnerProduct;
+            int64_t dim = 0;
+            torch::ScalarType dtype = torch::kFloat32;
+            int64_t nlist = 100;
+            int64_t nprobe = 8;
+            int64_t nextId = 0;
+            // [nlist, dim], undefined until trained
+            torch::Tensor centroids;
+            std::vector<VectorStore> lists;
+        };
+
+        // Inverted file index: vectors live in the list of their nearest k-means centroid and a search only scans the nprobe closest lists
+        class IVFIndex : public Napi::ObjectWrap<IVFIndex>
+        {
+
+        public:
+            std::shared_ptr<IVFState> state;
+
+            static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+            static Napi::Object FromState(Napi::Env env, const std::shared_ptr<IVFState> &state);
+
+            // [meta, centroids, vectors0, ids0, vectors1, ids1, ...] for torch::save
+            static std::vector<torch::Tensor> ToTensors(IVFState &state);
+
+            static std::shared_ptr<IVFState> FromTensors(const std::vector<torch::Tensor> &tensors);
+
+            IVFIndex(const Napi::CallbackInfo &info);
+
+            Napi::Value Train(const Napi::CallbackInfo &info);
+
+            Napi::Value Add(const Napi::CallbackInfo &info);
+
+            Napi::Value Remove(const Napi::CallbackInfo &info);
+
+            Napi::Value Search(const Napi::CallbackInfo &info);
+
+            Napi::Value Save(const Napi::CallbackInfo &info);
+
+            Napi::Value Size(const Napi::CallbackInfo &info);
+
+            Napi::Value Dim(const Napi::CallbackInfo &info);
+
+            Napi::Value MetricName(const Napi::CallbackInfo &info);
+
+            Napi::Value Trained(const Napi::CallbackInfo &info);
+
+            Napi::Value GetNprobe(const Napi::CallbackInfo &info);
+
+            void SetNprobe(const Napi::CallbackInfo &info, const Napi::Value &value);
+        };
+    }
+}
@@ -0,0 +1,208 @@
+#include <addon/index/VectorStore.hpp>
+
+#include <limits>
+
+namespace nodeml_torch
+{
+    namespace index
+    {
+        // Rows scored per matmul, bounds the [queries, block] score matrix
+        static const int64_t searchBlockSize = 65536;
+
+        static const double negativeInfinity = -std::numeric_limits<double>::infinity();
+
+        Metric metricFromString(const std::string &name)
+        {
+            if (name == "ip")
+            {
+                return Metric::InnerProduct;
+            }
+            else if (name == "l2")
+            {
+                return Metric::L2;
+            }
+            else if (name == "cosine")
+            {
+                return Metric::Cosine;
+            }
+
+            throw std::invalid_argument("Unknown metric " + name + ", expected 'ip', 'l2' or 'cosine'");
+        }
+
+        std::string metricToString(Metric metric)
+        {
+            switch (metric)
+            {
+            case Metric::L2:
+                return "l2";
+            case Metric::Cosine:
+                return "cosine";
+            default:
+                return "ip";
+            }
+        }
+
+        Metric metricFromCode(int64_t code)
+        {
+            if (code < int64_t(Metric::InnerProduct) || code > int64_t(Metric::Cosine))
+            {
+                throw std::runtime_error("Unknown metric code " + std::to_string(code) + " in saved index");
+            }
+
+            return Metric(code);
+        }
+
+        void checkSavedRows(const torch::Tensor &vectors, const torch::Tensor &ids, int64_t dim)
+        {
+            if (vectors.dim() != 2 || vectors.size(1) != dim || ids.dim() != 1 || ids.size(0) != vectors.size(0))
+            {
+                throw std::runtime_error("Saved index vectors do not match its dim " + std::to_string(dim));
+            }
+        }
+
+        torch::Tensor prepareVectors(const torch::Tensor &vectors, int64_t dim, torch::ScalarType dtype, Metric metric)
+        {
+            auto rows = vectors.dim() == 1 ? vectors.unsqueeze(0) : vectors;
+
+            if (rows.dim() != 2 || rows.size(1) != dim)
+            {
+                throw std::invalid_argument("Expected vectors of shape [n, " + std::to_string(dim) + "]");
+            }
+
+            rows = rows.to(dtype).contiguous();
+
+            if (metric == Metric::Cosine)
+            {
+                rows = torch::nn::functional::normalize(rows, torch::nn::functional::NormalizeFuncOptions().dim(1));
+            }
+
+            return rows;
+        }
+
+        std::tuple<torch::Tensor, torch::Tensor> mergeTopK(const torch::Tensor &scoresA, const torch::Tensor &idsA,
+                                                           const torch::Tensor &scoresB, const torch::Tensor &idsB, int64_t k)
+        {
+            auto scores = torch::cat({scoresA, scoresB}, 1);
+            auto ids = torch::cat({idsA, idsB}, 1);
+            auto [top, positions] = scores.topk(std::min<int64_t>(k, scores.size(1)), 1);
+            return {top, ids.gather(1, positions)};
+        }
+
+        torch::Tensor scoresToDistances(const torch::Tensor &scores, Metric metric)
+        {
+            return metric == Metric::L2 ? -scores : scores;
+        }
+
+        void VectorStore::reserve(int64_t capacity)
+        {
+            auto current = vectors.defined() ? vectors.size(0) : 0;
+            if (capacity <= current)
+            {
+                return;
+            }
+
+            auto grown = std::max<int64_t>({capacity, current * 2, 1024});
+            auto newVectors = torch::empty({grown, dim}, torch::TensorOptions(dtype));
+            auto newIds = torch::empty({grown}, torch::TensorOptions(torch::kLong));
+            auto newNorms = torch::empty({grown}, torch::TensorOptions(dtype));
+
+            if (count > 0)
+            {
+                newVectors.narrow(0, 0, count).copy_(vectors.narrow(0, 0, count));
+                newIds.narrow(0, 0, count).copy_(ids.narrow(0, 0, count));
+                newNorms.narrow(0, 0, count).copy_(sqNorms.narrow(0, 0, count));
+            }
+
+            vectors = newVectors;
+            ids = newIds;
+            sqNorms = newNorms;
+        }
+
+        void VectorStore::append(const torch::Tensor &rows, const torch::Tensor &rowIds, Metric metric)
+        {
+            auto n = rows.size(0);
+            if (n == 0)
+            {
+                return;
+            }
+
+            reserve(count + n);
+
+            vectors.narrow(0, count, n).copy_(rows);
+            ids.narrow(0, count, n).copy_(rowIds);
+            if (metric == Metric::L2)
+            {
+                sqNorms.narrow(0, count, n).copy_(rows.pow(2).sum(1));
+            }
+
+            count += n;
+        }
+
+        int64_t VectorStore::remove(const torch::Tensor &removeIds)
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+
+            auto keep = torch::isin(activeIds(), removeIds, false, true).nonzero().squeeze(1);
+            auto kept = keep.size(0);
+            auto removed = count - kept;
+
+            if (removed > 0)
+            {
+                auto keptVectors = vectors.narrow(0, 0, count).index_select(0, keep);
+                auto keptIds = ids.narrow(0, 0, count).index_select(0, keep);
+                auto keptNorms = sqNorms.narrow(0, 0, count).index_select(0, keep);
+
+                vectors.narrow(0, 0, kept).copy_(keptVectors);
+                ids.narrow(0, 0, kept).copy_(keptIds);
+                sqNorms.narrow(0, 0, kept).copy_(keptNorms);
+                count = kept;
+            }
+
+            return removed;
+        }
+
+        std::tuple<torch::Tensor, torch::Tensor> VectorStore::search(const torch::Tensor &queries, int64_t k, Metric metric) const
+        {
+            auto numQueries = queries.size(0);
+            auto bestScores = torch::full({numQueries, k}, negativeInfinity, torch::TensorOptions(torch::kFloat32));
+            auto bestIds = torch::full({numQueries, k}, -1, torch::TensorOptions(torch::kLong));
+
+            for (int64_t start = 0; start < count; start += searchBlockSize)
+            {
+                auto n = std::min(searchBlockSize, count - start);
+                auto scores = torch::matmul(queries, vectors.narrow(0, start, n).t());
+
+                if (metric == Metric::L2)
+                {
+                    // -|q - x|^2 without the |q|^2 term, which is the same for every row
+                    scores = scores * 2 - sqNorms.narrow(0, start, n).unsqueeze(0);
+                }
+
+                auto [top, positions] = scores.topk(std::min(k, n), 1);
+                auto blockIds = ids.narrow(0, start, n).index({positions});
+
+                std::tie(bestScores, bestIds) = mergeTopK(bestScores, bestIds, top.to(torch::kFloat32), blockIds, k);
+            }
+
+            if (metric == Metric::L2 && count > 0)
+            {
+                bestScores = bestScores - queries.pow(2).sum(1, true).to(torch::kFloat32);
+            }
+
+            return {bestScores, bestIds};
+        }
+
+        torch::Tensor VectorStore::activeVectors() const
+        {
+            return count > 0 ? vectors.narrow(0, 0, count) : torch::empty({0, dim}, torch::TensorOptions(dtype));
+        }
+
+        torch::Tensor VectorStore::activeIds() const
+        {
+            return count > 0 ? ids.narrow(0, 0, count) : torch::empty({0}, torch::TensorOptions(torch::kLong));
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <torch/torch.h>
+#include <tuple>
+
+namespace nodeml_torch
+{
+    namespace index
+    {
+        enum class Metric
+        {
+            InnerProduct,
+            L2,
+            Cosine
+        };
+
+        Metric metricFromString(const std::string &name);
+
+        std::string metricToString(Metric metric);
+
+        // Metric stored in a saved meta tensor, throws for codes this version does not know
+        Metric metricFromCode(int64_t code);
+
+        // Checks a saved [n, dim] vectors / [n] ids pair before it is appended to a store
+        void checkSavedRows(const torch::Tensor &vectors, const torch::Tensor &ids, int64_t dim);
+
+        // Casts to the index dtype and checks the width, cosine vectors are normalized so search is a plain inner product
+        torch::Tensor prepareVectors(const torch::Tensor &vectors, int64_t dim, torch::ScalarType dtype, Metric metric);
+
+        // Keeps the k best of two candidate sets, scores are always larger-is-better
+        std::tuple<torch::Tensor, torch::Tensor> mergeTopK(const torch::Tensor &scoresA, const torch::Tensor &idsA,
+                                                           const torch::Tensor &scoresB, const torch::Tensor &idsB, int64_t k);
+
+        // L2 scores are negated squared distances internally, everything else is returned as is
+        torch::Tensor scoresToDistances(const torch::Tensor &scores, Metric metric);
+
+        // Rows of a flat index or of one IVF list, in tensors that grow by doubling
+        struct VectorStore
+        {
+            int64_t dim = 0;
+            torch::ScalarType dtype = torch::kFloat32;
+            int64_t count = 0;
+            torch::Tensor vectors;
+            torch::Tensor ids;
+            // Squared norms, only kept for L2
+            torch::Tensor sqNorms;
+
+            void reserve(int64_t capacity);
+
+            void append(const torch::Tensor &rows, const torch::Tensor &rowIds, Metric metric);
+
+            int64_t remove(const torch::Tensor &removeIds);
+
+            // Best k rows per query, missing results are -inf with id -1
+            std::tuple<torch::Tensor, torch::Tensor> search(const torch::Tensor &queries, int64_t k, Metric metric) const;
+
+            torch::Tensor activeVectors() const;
+
+            torch::Tensor activeIds() const;
+        };
+    }
+}
@@ -0,0 +1,92 @@
+#include <addon/index/index.hpp>
+#include <addon/index/FlatIndex.hpp>
+#include <addon/index/IVFIndex.hpp>
+#include <addon/FunctionWorker.hpp>
+
+namespace nodeml_torch
+{
+    namespace index
+    {
+        // Exactly one of the states is set once the worker has read the file
+        struct LoadedIndex
+        {
+            std::shared_ptr<FlatState> flat;
+            std::shared_ptr<IVFState> ivf;
+        };
+
+        Napi::Value load(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                if (!info[0].IsString())
+                {
+                    throw Napi::Error::New(env, "Path Must Be A String");
+                }
+
+                auto path = info[0].ToString().Utf8Value();
+
+                auto worker = new FunctionWorker<LoadedIndex>(
+                    env,
+                    [=]() -> LoadedIndex
+                    {
+                        std::vector<torch::Tensor> tensors;
+                        torch::load(tensors, path);
+
+                        if (tensors.empty() || tensors[0].numel() < 2 || tensors[0][0].item<int64_t>() != indexFormatVersion)
+                        {
+                            throw std::runtime_error("Not an index saved by this version of nodeml_torch");
+                        }
+
+                        // The state is rebuilt here so a corrupt file rejects the promise instead of throwing on the JS thread
+                        LoadedIndex loaded;
+                        auto kind = tensors[0][1].item<int64_t>();
+                        if (kind == int64_t(IndexKind::IVF))
+                        {
+                            loaded.ivf = IVFIndex::FromTensors(tensors);
+                        }
+                        else if (kind == int64_t(IndexKind::Flat))
+                        {
+                            loaded.flat = FlatIndex::FromTensors(tensors);
+                        }
+                        else
+                        {
+                            throw std::runtime_error("Unknown index kind " + std::to_string(kind));
+                        }
+
+                        return loaded;
+                    },
+                    [=](Napi::Env env, LoadedIndex loaded) -> Napi::Value
+                    {
+                        if (loaded.ivf)
+                        {
+                            return IVFIndex::FromState(env, loaded.ivf);
+                        }
+
+                        return FlatIndex::FromState(env, loaded.flat);
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Object Init(Napi::Env env, Napi::Object exports)
+        {
+            auto myExports = Napi::Object::New(env);
+
+            FlatIndex::Init(env, myExports);
+            IVFIndex::Init(env, myExports);
+
+            myExports.Set("load", Napi::Function::New(env, load));
+
+            exports.Set("index", myExports);
+
+            return exports;
+        }
+    }
+}
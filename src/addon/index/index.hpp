@@ -0,0 +1,22 @@
+#pragma once
+
+#include <napi.h>
+
+namespace nodeml_torch
+{
+    namespace index
+    {
+        // Leading values of the meta tensor written by save(), bump the version when the layout changes
+        static const int64_t indexFormatVersion = 1;
+
+        enum class IndexKind : int64_t
+        {
+            Flat = 0,
+            IVF = 1
+        };
+
+        Napi::Value load(const Napi::CallbackInfo &info);
+
+        Napi::Object Init(Napi::Env env, Napi::Object exports);
+    }
+}
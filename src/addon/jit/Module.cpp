@@ -1,23 +1,34 @@
 #include <addon/jit/Module.hpp>
+#include <addon/AddonData.hpp>
 #include <addon/FunctionWorker.hpp>
 #include <addon/Tensor.hpp>
+#include <addon/jit/generate.hpp>
+#include <addon/utils.hpp>
 #include "Module.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 namespace nodeml_torch
 {
     namespace jit
     {
 
-        Napi::FunctionReference JitModule::constructor;
-
         Napi::Object JitModule::Init(Napi::Env env, Napi::Object exports)
         {
             auto func = DefineClass(env, "Module",
                                     {
                                         JitModule::InstanceMethod("forward", &JitModule::Forward),
+                                        JitModule::InstanceMethod("generate", &JitModule::Generate),
+                                        JitModule::InstanceMethod("share", &JitModule::Share),
+                                        JitModule::InstanceMethod("loadStateDict", &JitModule::LoadStateDict),
+                                        JitModule::InstanceMethod("setAutocast", &JitModule::SetAutocast),
+                                        JitModule::InstanceAccessor("quantization", &JitModule::Quantization, nullptr),
+                                        JitModule::InstanceMethod("toMemoryFormat", &JitModule::ToMemoryFormat),
                                     });
 
-            constructor = Napi::Persistent(func);
-            constructor.SuppressDestruct();
+            AddonData::Get(env)->jitModuleConstructor = Napi::Persistent(func);
             exports.Set("Module", func);
             return exports;
         }
@@ -31,7 +42,7 @@ namespace nodeml_torch
             try
             {
                 Napi::EscapableHandleScope scope(env);
-                auto newModule = JitModule::constructor.New({});
+                auto newModule = AddonData::Get(env)->jitModuleConstructor.New({});
                 Napi::ObjectWrap<JitModule>::Unwrap(newModule)->torchModule = torchJitModule;
                 return scope.Escape(newModule).ToObject();
             }
@@ -47,7 +58,11 @@ namespace nodeml_torch
             try
             {
                 torch::NoGradGuard no_grad;
-                torchModule.eval();
+                // Shared modules are used from several threads, so only write the flag when it changes
+                if (torchModule.is_training())
+                {
+                    torchModule.eval();
+                }
                 auto env = info.Env();
 
                 auto len = info.Length();
@@ -58,12 +73,17 @@ namespace nodeml_torch
                     inputs.push_back(JSTypeToIValue(env, info[i]));
                 }
 
+                // Copied so setAutocast during a pending forward does not race with the worker
+                auto autocastOptions = autocast;
+
                 auto worker = new FunctionWorker<c10::IValue>(
                     info.Env(),
                     [=]() -> c10::IValue
                     {
                         torch::NoGradGuard no_grad;
-                        return torchModule.forward(inputs);
+                        return runWithAutocast([&]() -> c10::IValue
+                                               { return torchModule.forward(inputs); },
+                                               autocastOptions);
                     },
                     [=](Napi::Env env, c10::IValue value) -> Napi::Value
                     {
@@ -79,6 +99,466 @@ namespace nodeml_torch
             }
         }
 
+        static GenerateOptions generateOptionsFromObject(const Napi::Object &options)
+        {
+            GenerateOptions result;
+
+            if (options.Has("maxNewTokens"))
+            {
+                result.maxNewTokens = std::max<int64_t>(0, options.Get("maxNewTokens").ToNumber().Int64Value());
+            }
+
+            if (options.Has("eosTokenId"))
+            {
+                auto eos = options.Get("eosTokenId");
+                if (eos.IsArray())
+                {
+                    result.eosTokenIds = utils::napiArrayToVector<int64_t>(eos.As<Napi::Array>());
+                }
+                else if (eos.IsNumber())
+                {
+                    result.eosTokenIds.push_back(eos.ToNumber().Int64Value());
+                }
+            }
+
+            if (options.Has("padTokenId"))
+            {
+                result.padTokenId = options.Get("padTokenId").ToNumber().Int64Value();
+            }
+
+            if (options.Has("pastKeyValuesMethod"))
+            {
+                result.pastKeyValuesMethod = options.Get("pastKeyValuesMethod").ToString().Utf8Value();
+            }
+
+            if (options.Has("sampling") && options.Get("sampling").IsObject())
+            {
+                auto sampling = options.Get("sampling").ToObject();
+
+                // Asking for sampling without a temperature means sampling from the unscaled distribution
+                result.sampling.temperature = sampling.Has("temperature") ? sampling.Get("temperature").ToNumber().DoubleValue() : 1.0;
+
+                if (sampling.Has("topK"))
+                {
+                    result.sampling.topK = sampling.Get("topK").ToNumber().Int64Value();
+                }
+
+                if (sampling.Has("topP"))
+                {
+                    result.sampling.topP = sampling.Get("topP").ToNumber().DoubleValue();
+                }
+
+                if (sampling.Has("seed"))
+                {
+                    result.seed = uint64_t(sampling.Get("seed").ToNumber().Int64Value());
+                }
+            }
+
+            return result;
+        }
+
+        // Settled from the onToken ThreadSafeFunction's finalizer, which only runs once every queued token has been delivered
+        struct GenerateCompletion
+        {
+            Napi::Promise::Deferred deferred;
+            torch::Tensor sequences;
+            std::string error;
+        };
+
+        Napi::Value JitModule::Generate(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto inputIds = Tensor::FromObject(info[0])->torchTensor;
+                auto options = info.Length() > 1 && info[1].IsObject() ? generateOptionsFromObject(info[1].ToObject()) : GenerateOptions();
+                auto module = torchModule;
+
+                // Set from the signal's abort listener, checked after every step
+                std::shared_ptr<std::atomic<bool>> aborted;
+                if (info.Length() > 1 && info[1].IsObject() && info[1].ToObject().Get("signal").IsObject())
+                {
+                    auto signal = info[1].ToObject().Get("signal").ToObject();
+                    aborted = std::make_shared<std::atomic<bool>>(signal.Get("aborted").ToBoolean().Value());
+
+                    auto listener = Napi::Function::New(env, [aborted](const Napi::CallbackInfo &)
+                                                        { aborted->store(true); });
+                    auto listenerOptions = Napi::Object::New(env);
+                    listenerOptions.Set("once", true);
+                    signal.Get("addEventListener").As<Napi::Function>().Call(signal, {Napi::String::New(env, "abort"), listener, listenerOptions});
+                }
+
+                std::shared_ptr<GenerateCompletion> completion;
+
+                // Tokens are posted to onToken from the worker thread as soon as they are sampled
+                std::shared_ptr<Napi::ThreadSafeFunction> onToken;
+                if (info.Length() > 1 && info[1].IsObject() && info[1].ToObject().Get("onToken").IsFunction())
+                {
+                    completion = std::make_shared<GenerateCompletion>(GenerateCompletion{Napi::Promise::Deferred::New(env)});
+                    onToken = std::make_shared<Napi::ThreadSafeFunction>(
+                        Napi::ThreadSafeFunction::New(env, info[1].ToObject().Get("onToken").As<Napi::Function>(), "nodeml_torch.generate", 0, 1,
+                                                      [completion](Napi::Env env)
+                                                      {
+                                                          if (!completion->error.empty())
+                                                          {
+                                                              completion->deferred.Reject(Napi::Error::New(env, completion->error).Value());
+                                                          }
+                                                          else
+                                                          {
+                                                              completion->deferred.Resolve(Tensor::FromTorchTensor(env, completion->sequences));
+                                                          }
+                                                      }));
+                }
+
+                std::function<bool(const std::vector<int64_t> &)> onStep;
+                if (aborted)
+                {
+                    onStep = [aborted](const std::vector<int64_t> &)
+                    {
+                        return !aborted->load();
+                    };
+                }
+
+                if (onToken)
+                {
+                    onStep = [onToken, aborted](const std::vector<int64_t> &tokens)
+                    {
+                        onToken->BlockingCall(new std::vector<int64_t>(tokens),
+                                              [](Napi::Env env, Napi::Function callback, std::vector<int64_t> *tokens)
+                                              {
+                                                  if (env != nullptr && callback != nullptr)
+                                                  {
+                                                      callback.Call({utils::vectorToNapiArray(env, *tokens)});
+                                                  }
+                                                  delete tokens;
+                                              });
+                        return !aborted || !aborted->load();
+                    };
+                }
+
+                if (!onToken)
+                {
+                    auto worker = new FunctionWorker<torch::Tensor>(
+                        env,
+                        [=]() -> torch::Tensor
+                        {
+                            return generate(module, inputIds, options, onStep);
+                        },
+                        [=](Napi::Env env, torch::Tensor value) -> Napi::Value
+                        {
+                            return Tensor::FromTorchTensor(env, value);
+                        });
+
+                    worker->Queue();
+                    return worker->GetPromise();
+                }
+
+                // The worker's own promise only ever resolves, the result travels through the completion
+                auto worker = new FunctionWorker<bool>(
+                    env,
+                    [=]() -> bool
+                    {
+                        try
+                        {
+                            completion->sequences = generate(module, inputIds, options, onStep);
+                        }
+                        catch (const std::exception &e)
+                        {
+                            completion->error = e.what();
+                        }
+                        catch (...)
+                        {
+                            completion->error = "Generation failed";
+                        }
+
+                        onToken->Release();
+                        return true;
+                    },
+                    [=](Napi::Env env, bool) -> Napi::Value
+                    {
+                        return env.Undefined();
+                    });
+
+                worker->Queue();
+                return completion->deferred.Promise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        // Process wide, entries are weak so a handle never keeps a model alive on its own
+        static std::mutex sharedModulesMutex;
+        struct SharedModuleEntry
+        {
+            c10::weak_intrusive_ptr<c10::ivalue::Object> module;
+            std::string sharedWeights;
+            c10::optional<QuantizationReport> quantization;
+        };
+
+        static std::unordered_map<uint64_t, SharedModuleEntry> sharedModules;
+        static std::atomic<uint64_t> nextSharedModuleId{1};
+
+        Napi::Value JitModule::Share(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                if (torchModule.is_training())
+                {
+                    torchModule.eval();
+                }
+
+                auto id = nextSharedModuleId++;
+                {
+                    std::lock_guard<std::mutex> lock(sharedModulesMutex);
+                    for (auto it = sharedModules.begin(); it != sharedModules.end();)
+                    {
+                        it = it->second.module.expired() ? sharedModules.erase(it) : std::next(it);
+                    }
+
+                    sharedModules.emplace(id, SharedModuleEntry{c10::weak_intrusive_ptr<c10::ivalue::Object>(torchModule._ivalue()), sharedWeights, quantization});
+                }
+
+                auto handle = Napi::Object::New(env);
+                handle.Set("sharedModuleId", Napi::Number::New(env, double(id)));
+                return handle;
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Object JitModule::FromSharedHandle(Napi::Env env, const Napi::Value &handle)
+        {
+            if (!handle.IsObject() || !handle.ToObject().Has("sharedModuleId"))
+            {
+                throw std::invalid_argument("Expected a handle returned by module.share()");
+            }
+
+            auto id = uint64_t(handle.ToObject().Get("sharedModuleId").ToNumber().Int64Value());
+
+            SharedModuleEntry entry;
+            {
+                std::lock_guard<std::mutex> lock(sharedModulesMutex);
+                auto found = sharedModules.find(id);
+                if (found != sharedModules.end())
+                {
+                    entry = found->second;
+                }
+            }
+
+            auto module = entry.module.lock();
+            if (!module)
+            {
+                throw std::runtime_error("The shared module has been released, keep the original Module alive until every thread has called fromShared");
+            }
+
+            auto object = FromTorchJitModule(env, torch::jit::Module(module));
+            auto wrapped = Napi::ObjectWrap<JitModule>::Unwrap(object);
+            wrapped->sharedWeights = entry.sharedWeights;
+            wrapped->quantization = entry.quantization;
+            return object;
+        }
+
+        Napi::Value JitModule::LoadStateDict(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                if (!info[0].IsObject())
+                {
+                    throw Napi::Error::New(env, "State Dict Must Be An Object");
+                }
+
+                bool strict = true;
+                if (info.Length() > 1 && info[1].IsObject() && info[1].ToObject().Has("strict"))
+                {
+                    strict = info[1].ToObject().Get("strict").ToBoolean().Value();
+                }
+
+                std::vector<std::pair<std::string, torch::Tensor>> targets;
+                for (const auto &item : torchModule.named_parameters(true))
+                {
+                    targets.emplace_back(item.name, item.value);
+                }
+                for (const auto &item : torchModule.named_buffers(true))
+                {
+                    targets.emplace_back(item.name, item.value);
+                }
+
+                auto stateDict = info[0].ToObject();
+                auto missingKeys = Napi::Array::New(env);
+                auto unexpectedKeys = Napi::Array::New(env);
+                std::vector<std::pair<torch::Tensor, torch::Tensor>> updates;
+                std::unordered_set<std::string> known;
+
+                for (const auto &[name, target] : targets)
+                {
+                    known.insert(name);
+                    if (!stateDict.Has(name))
+                    {
+                        missingKeys.Set(missingKeys.Length(), name);
+                        continue;
+                    }
+
+                    auto value = stateDict.Get(name);
+                    if (!value.IsObject() || !Tensor::IsInstance(value.ToObject()))
+                    {
+                        throw Napi::Error::New(env, name + " Is Not A Tensor");
+                    }
+
+                    auto source = Tensor::FromObject(value)->torchTensor;
+                    if (source.sizes() != target.sizes())
+                    {
+                        throw Napi::Error::New(env, "Shape mismatch for " + name + ": expected " + c10::str(target.sizes()) + ", got " + c10::str(source.sizes()));
+                    }
+                    updates.emplace_back(target, source);
+                }
+
+                auto keys = stateDict.GetPropertyNames();
+                for (uint32_t i = 0; i < keys.Length(); i++)
+                {
+                    auto key = keys.Get(i).ToString().Utf8Value();
+                    if (known.find(key) == known.end())
+                    {
+                        unexpectedKeys.Set(unexpectedKeys.Length(), key);
+                    }
+                }
+
+                if (strict && (missingKeys.Length() > 0 || unexpectedKeys.Length() > 0))
+                {
+                    throw Napi::Error::New(env, "State dict does not match the module: " + std::to_string(missingKeys.Length()) + " missing and " +
+                                                    std::to_string(unexpectedKeys.Length()) + " unexpected keys");
+                }
+
+                // Nothing is touched until every entry has been validated
+                torch::NoGradGuard noGrad;
+                for (auto &[target, source] : updates)
+                {
+                    target.set_data(source.to(target.device(), target.scalar_type()));
+                }
+
+                auto result = Napi::Object::New(env);
+                result.Set("missingKeys", missingKeys);
+                result.Set("unexpectedKeys", unexpectedKeys);
+                return result;
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value JitModule::SetAutocast(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto mode = info.Length() > 0 && info[0].IsString() ? info[0].ToString().Utf8Value() : std::string("none");
+                if (mode != "bf16" && mode != "none")
+                {
+                    throw Napi::Error::New(env, "Autocast mode must be 'bf16' or 'none'");
+                }
+
+                AutocastOptions options;
+                bool force = false;
+                if (info.Length() > 1 && info[1].IsObject())
+                {
+                    auto object = info[1].ToObject();
+                    if (object.Has("castOutputs"))
+                    {
+                        options.castOutputs = object.Get("castOutputs").ToBoolean().Value();
+                    }
+                    if (object.Has("force"))
+                    {
+                        force = object.Get("force").ToBoolean().Value();
+                    }
+                }
+
+                options.enabled = mode == "bf16" && (force || cpuSupportsBFloat16());
+                autocast = options;
+
+                return Napi::Boolean::New(env, options.enabled);
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value JitModule::Quantization(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            if (!quantization)
+            {
+                return env.Null();
+            }
+
+            auto report = Napi::Object::New(env);
+            report.Set("mode", quantization->mode);
+            report.Set("engine", quantization->engine);
+            report.Set("linearLayers", Napi::Number::New(env, double(quantization->linearLayers)));
+            report.Set("bytesBefore", Napi::Number::New(env, double(quantization->bytesBefore)));
+            report.Set("bytesAfter", Napi::Number::New(env, double(quantization->bytesAfter)));
+            return report;
+        }
+
+        Napi::Value JitModule::ToMemoryFormat(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                if (!info[0].IsString())
+                {
+                    throw Napi::Error::New(env, "Memory Format Must Be A String");
+                }
+
+                // Frozen modules keep their weights as constants, set_data would silently change nothing
+                if (quantization)
+                {
+                    throw Napi::Error::New(env, "toMemoryFormat is not supported on quantized modules");
+                }
+
+                // Restriding copies into private memory, every parameter would leave the segment
+                if (!sharedWeights.empty())
+                {
+                    throw Napi::Error::New(env, "toMemoryFormat would copy the weights out of shared memory " + sharedWeights +
+                                                    ", load without sharedWeights to restride them");
+                }
+
+                auto format = utils::stringToMemoryFormat(info[0].ToString().Utf8Value());
+                int64_t dims = format == torch::MemoryFormat::ChannelsLast3d ? 5 : 4;
+
+                std::vector<torch::Tensor> tensors;
+                for (const auto &item : torchModule.named_parameters(true))
+                {
+                    tensors.push_back(item.value);
+                }
+                for (const auto &item : torchModule.named_buffers(true))
+                {
+                    tensors.push_back(item.value);
+                }
+
+                torch::NoGradGuard noGrad;
+                for (auto &tensor : tensors)
+                {
+                    if (tensor.dim() == dims || format == torch::MemoryFormat::Contiguous)
+                    {
+                        tensor.set_data(tensor.contiguous(format));
+                    }
+                }
+
+                return info.This();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
         Napi::Value JitModule::Eval(const Napi::CallbackInfo &info)
         {
             try
@@ -2,6 +2,9 @@
 
 #include <napi.h>
 
+#include <addon/jit/autocast.hpp>
+#include <addon/jit/quantize.hpp>
+
 #include <memory>
 #include <string>
 #include <torch/torch.h>
@@ -14,10 +17,16 @@ namespace nodeml_torch
         {
 
         public:
-            static Napi::FunctionReference constructor;
-
             torch::jit::Module torchModule;
 
+            AutocastOptions autocast;
+
+            // Set when the module was quantized at load time
+            c10::optional<QuantizationReport> quantization;
+
+            // Segment name when jit.load mapped the weights with sharedWeights
+            std::string sharedWeights;
+
             static Napi::Object Init(Napi::Env env, Napi::Object exports);
 
             JitModule(const Napi::CallbackInfo &info);
@@ -26,6 +35,27 @@ namespace nodeml_torch
 
             Napi::Value Forward(const Napi::CallbackInfo &info);
 
+            Napi::Value Generate(const Napi::CallbackInfo &info);
+
+            // A structured-clonable handle that other threads of this process turn back into a Module with the same weights
+            Napi::Value Share(const Napi::CallbackInfo &info);
+
+            // A Module over the same weights, carrying how they were loaded. Throws when every Module holding
+            // the shared weights has been garbage collected
+            static Napi::Object FromSharedHandle(Napi::Env env, const Napi::Value &handle);
+
+            // Points parameters and buffers at the given tensors, converting only when device or dtype differ
+            Napi::Value LoadStateDict(const Napi::CallbackInfo &info);
+
+            // Returns whether autocast is on, 'bf16' stays off on CPUs without native bfloat16 unless forced
+            Napi::Value SetAutocast(const Napi::CallbackInfo &info);
+
+            Napi::Value Quantization(const Napi::CallbackInfo &info);
+
+            // Restrides 4d (or 5d for channelsLast3d) parameters and buffers in place, throws for quantized modules
+            // and weights mapped from shared memory
+            Napi::Value ToMemoryFormat(const Napi::CallbackInfo &info);
+
             Napi::Value Eval(const Napi::CallbackInfo &info);
 
             Napi::Value Cuda(const Napi::CallbackInfo &info);
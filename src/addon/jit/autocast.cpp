@@ -0,0 +1,135 @@
+#include <addon/jit/autocast.hpp>
+
+#include <ATen/autocast_mode.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace nodeml_torch
+{
+    namespace jit
+    {
+        bool cpuSupportsBFloat16()
+        {
+            static const bool supported = []()
+            {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+                int leaf0[4], leaf1[4];
+                __cpuidex(leaf0, 7, 0);
+                __cpuidex(leaf1, 7, 1);
+                // AMX-BF16 is leaf 7.0 EDX bit 22, AVX512-BF16 leaf 7.1 EAX bit 5
+                return (leaf0[3] & (1 << 22)) != 0 || (leaf1[0] & (1 << 5)) != 0;
+#elif defined(__x86_64__) || defined(__i386__)
+                unsigned int eax, ebx, ecx, edx;
+                bool amx = __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (edx & (1u << 22)) != 0;
+                bool avx512 = __get_cpuid_count(7, 1, &eax, &ebx, &ecx, &edx) && (eax & (1u << 5)) != 0;
+                return amx || avx512;
+#else
+                return false;
+#endif
+            }();
+
+            return supported;
+        }
+
+        // Autocast state is thread local, the guard restores whatever the worker thread had before
+        class CpuAutocastGuard
+        {
+        public:
+            CpuAutocastGuard() : previousEnabled(at::autocast::is_cpu_enabled()), previousDtype(at::autocast::get_autocast_cpu_dtype())
+            {
+                at::autocast::set_cpu_enabled(true);
+                at::autocast::set_autocast_cpu_dtype(at::kBFloat16);
+                at::autocast::increment_nesting();
+            }
+
+            ~CpuAutocastGuard()
+            {
+                if (at::autocast::decrement_nesting() == 0)
+                {
+                    at::autocast::clear_cache();
+                }
+                at::autocast::set_cpu_enabled(previousEnabled);
+                at::autocast::set_autocast_cpu_dtype(previousDtype);
+            }
+
+        private:
+            bool previousEnabled;
+            at::ScalarType previousDtype;
+        };
+
+        c10::IValue castFloatingTensors(const c10::IValue &value, torch::ScalarType dtype)
+        {
+            if (value.isTensor())
+            {
+                auto tensor = value.toTensor();
+                return tensor.is_floating_point() ? tensor.to(dtype) : tensor;
+            }
+
+            if (value.isTuple())
+            {
+                std::vector<c10::IValue> elements;
+                for (const auto &element : value.toTupleRef().elements())
+                {
+                    elements.push_back(castFloatingTensors(element, dtype));
+                }
+                return c10::ivalue::Tuple::create(std::move(elements));
+            }
+
+            if (value.isList())
+            {
+                auto list = value.toList();
+                c10::impl::GenericList result(list.elementType());
+                for (const auto &element : list)
+                {
+                    result.push_back(castFloatingTensors(element, dtype));
+                }
+                return result;
+            }
+
+            if (value.isGenericDict())
+            {
+                auto dict = value.toGenericDict();
+                c10::impl::GenericDict result(dict.keyType(), dict.valueType());
+                for (const auto &entry : dict)
+                {
+                    result.insert(entry.key(), castFloatingTensors(entry.value(), dtype));
+                }
+                return result;
+            }
+
+            return value;
+        }
+
+        c10::IValue runWithAutocast(const std::function<c10::IValue()> &fn, const AutocastOptions &options)
+        {
+            if (!options.enabled || options.state->disabled)
+            {
+                return fn();
+            }
+
+            c10::IValue result;
+            try
+            {
+                CpuAutocastGuard guard;
+                result = fn();
+            }
+            catch (const c10::Error &)
+            {
+                // A rerun doubles latency and repeats side effects, so genuine errors only pay for it once
+                if (options.state->fallbackTried.exchange(true))
+                {
+                    throw;
+                }
+
+                result = fn();
+                options.state->disabled = true;
+            }
+
+            return options.castOutputs ? castFloatingTensors(result, torch::kFloat) : result;
+        }
+    }
+}
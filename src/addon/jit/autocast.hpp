@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <torch/script.h>
+
+namespace nodeml_torch
+{
+    namespace jit
+    {
+        // Shared by a module and its pending forwards, the float32 fallback is tried at most once
+        struct AutocastState
+        {
+            std::atomic<bool> fallbackTried{false};
+            // Set once a forward failed under autocast and then succeeded in float32
+            std::atomic<bool> disabled{false};
+        };
+
+        struct AutocastOptions
+        {
+            bool enabled = false;
+            // Floating point outputs are returned as float32
+            bool castOutputs = false;
+            std::shared_ptr<AutocastState> state = std::make_shared<AutocastState>();
+        };
+
+        // x86 CPUs with AVX512-BF16 or AMX-BF16 run bfloat16 matmuls natively, elsewhere autocast only adds casts
+        bool cpuSupportsBFloat16();
+
+        // Runs fn under CPU bfloat16 autocast on the calling thread. The first failure, for instance an op without a
+        // bfloat16 kernel, is rerun once in float32 and turns autocast off if that succeeds. Later errors are reported as they are
+        c10::IValue runWithAutocast(const std::function<c10::IValue()> &fn, const AutocastOptions &options);
+
+        // Casts every floating point tensor nested in value, other values are returned as they are
+        c10::IValue castFloatingTensors(const c10::IValue &value, torch::ScalarType dtype);
+    }
+}
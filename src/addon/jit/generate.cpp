@@ -0,0 +1,100 @@
+#include <addon/jit/generate.hpp>
+
+#include <algorithm>
+
+namespace nodeml_torch
+{
+    namespace jit
+    {
+        // Models return either logits or a tuple led by logits, of shape [batch, vocab] or [batch, seq, vocab]
+        static torch::Tensor lastLogits(const c10::IValue &output)
+        {
+            auto logits = output.isTuple() ? output.toTupleRef().elements()[0].toTensor() : output.toTensor();
+            return logits.dim() == 3 ? logits.select(1, -1) : logits;
+        }
+
+        torch::Tensor generate(torch::jit::Module module, const torch::Tensor &inputIds, const GenerateOptions &options,
+                               const std::function<bool(const std::vector<int64_t> &)> &onStep)
+        {
+            torch::NoGradGuard no_grad;
+            if (module.is_training())
+            {
+                module.eval();
+            }
+
+            auto sequences = (inputIds.dim() == 1 ? inputIds.unsqueeze(0) : inputIds).to(torch::kLong);
+            auto batch = sequences.size(0);
+
+            c10::optional<at::Generator> generator;
+            if (options.seed.has_value())
+            {
+                generator = sampling::makeGenerator(*options.seed);
+            }
+
+            auto eos = torch::tensor(options.eosTokenIds, torch::TensorOptions(torch::kLong).device(sequences.device()));
+            auto pad = options.padTokenId.value_or(options.eosTokenIds.empty() ? 0 : options.eosTokenIds[0]);
+            auto finished = torch::zeros({batch}, torch::TensorOptions(torch::kBool).device(sequences.device()));
+
+            c10::optional<torch::jit::Method> cachedMethod;
+            if (!options.pastKeyValuesMethod.empty())
+            {
+                cachedMethod = module.get_method(options.pastKeyValuesMethod);
+            }
+
+            c10::IValue past;
+            auto stepInput = sequences;
+            std::vector<torch::Tensor> generated;
+            generated.reserve(options.maxNewTokens);
+
+            for (int64_t step = 0; step < options.maxNewTokens; step++)
+            {
+                torch::Tensor logits;
+                if (cachedMethod.has_value())
+                {
+                    auto output = (*cachedMethod)({stepInput, past});
+                    auto elements = output.toTupleRef().elements();
+                    logits = lastLogits(elements[0]);
+                    past = elements[1];
+                }
+                else
+                {
+                    logits = lastLogits(module.forward({stepInput}));
+                }
+
+                auto next = sampling::sample(logits, options.sampling, generator).to(torch::kLong);
+                next = torch::where(finished, torch::full_like(next, pad), next);
+
+                if (eos.numel() > 0)
+                {
+                    finished = finished | torch::isin(next, eos);
+                }
+
+                generated.push_back(next);
+
+                if (onStep)
+                {
+                    auto cpuNext = next.cpu().contiguous();
+                    if (!onStep(std::vector<int64_t>(cpuNext.data_ptr<int64_t>(), cpuNext.data_ptr<int64_t>() + cpuNext.numel())))
+                    {
+                        break;
+                    }
+                }
+
+                if (eos.numel() > 0 && finished.all().item<bool>())
+                {
+                    break;
+                }
+
+                // With a cache only the new token is fed back, otherwise the whole sequence is rerun
+                stepInput = cachedMethod.has_value() ? next.unsqueeze(1) : torch::cat({stepInput, next.unsqueeze(1)}, 1);
+            }
+
+            if (generated.empty())
+            {
+                return sequences;
+            }
+
+            return torch::cat({sequences, torch::stack(generated, 1)}, 1);
+        }
+    }
+}
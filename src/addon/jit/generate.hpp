@@ -0,0 +1,29 @@
+#pragma once
+
+#include <addon/sampling.hpp>
+#include <functional>
+#include <string>
+#include <torch/script.h>
+
+namespace nodeml_torch
+{
+    namespace jit
+    {
+        struct GenerateOptions
+        {
+            int64_t maxNewTokens = 32;
+            std::vector<int64_t> eosTokenIds;
+            // Written after a sequence has finished, defaults to the first eos token
+            c10::optional<int64_t> padTokenId;
+            sampling::SamplingOptions sampling;
+            c10::optional<uint64_t> seed;
+            // Method called as (inputIds, pastKeyValues | None) -> (logits, pastKeyValues), empty to rerun forward on the whole sequence
+            std::string pastKeyValuesMethod;
+        };
+
+        // Runs the decode loop natively, the cache returned by the model never leaves C++.
+        // onStep receives the new token of each sequence and returns false to stop early
+        torch::Tensor generate(torch::jit::Module module, const torch::Tensor &inputIds, const GenerateOptions &options,
+                               const std::function<bool(const std::vector<int64_t> &)> &onStep);
+    }
+}
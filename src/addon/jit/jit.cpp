@@ -2,11 +2,39 @@
 #include <torch/script.h>
 #include <addon/FunctionWorker.hpp>
 #include <addon/jit/Module.hpp>
+#include <addon/shm/shm.hpp>
+#include <addon/utils.hpp>
 
 namespace nodeml_torch
 {
     namespace jit
     {
+        struct LoadedModule
+        {
+            torch::jit::Module module;
+            c10::optional<QuantizationReport> quantization;
+        };
+
+        // Module::to would also convert integer buffers such as position_ids, which must stay integers for lookups
+        static void convertFloatingWeights(torch::jit::Module &module, torch::ScalarType dtype)
+        {
+            torch::NoGradGuard noGrad;
+            for (const auto &item : module.named_parameters(true))
+            {
+                if (item.value.is_floating_point())
+                {
+                    item.value.set_data(item.value.to(dtype));
+                }
+            }
+            for (const auto &item : module.named_buffers(true))
+            {
+                if (item.value.is_floating_point())
+                {
+                    item.value.set_data(item.value.to(dtype));
+                }
+            }
+        }
+
         Napi::Value load(const Napi::CallbackInfo &info)
         {
 
@@ -20,16 +48,72 @@ namespace nodeml_torch
                 }
 
                 auto modulePath = info[0].ToString().Utf8Value();
+                std::string sharedWeights;
+                c10::optional<torch::ScalarType> dtype;
+                bool quantize = false;
 
-                auto worker = new FunctionWorker<torch::jit::Module>(
+                if (info.Length() > 1 && info[1].IsObject())
+                {
+                    auto options = info[1].ToObject();
+                    if (options.Has("sharedWeights"))
+                    {
+                        sharedWeights = options.Get("sharedWeights").ToString().Utf8Value();
+                    }
+                    if (options.Has("dtype"))
+                    {
+                        dtype = utils::stringToScalarType(options.Get("dtype").ToString().Utf8Value());
+                        if (!at::isFloatingType(*dtype))
+                        {
+                            throw Napi::Error::New(env, "dtype must be a floating point type");
+                        }
+                    }
+                    if (options.Has("quantize"))
+                    {
+                        auto mode = options.Get("quantize").ToString().Utf8Value();
+                        if (mode != "dynamic-int8" && mode != "none")
+                        {
+                            throw Napi::Error::New(env, "quantize must be 'dynamic-int8' or 'none'");
+                        }
+                        quantize = mode == "dynamic-int8";
+                    }
+                }
+
+                // Frozen modules keep their weights as graph constants, there is nothing left to share
+                if (quantize && !sharedWeights.empty())
+                {
+                    throw Napi::Error::New(env, "quantize and sharedWeights can not be combined");
+                }
+
+                auto worker = new FunctionWorker<LoadedModule>(
                     info.Env(),
-                    [=]() -> torch::jit::Module
+                    [=]() -> LoadedModule
                     {
-                        return torch::jit::load(modulePath);
+                        LoadedModule loaded;
+                        loaded.module = torch::jit::load(modulePath);
+                        // Converted before sharing so every process maps the narrower weights
+                        if (dtype)
+                        {
+                            convertFloatingWeights(loaded.module, *dtype);
+                        }
+                        if (quantize)
+                        {
+                            QuantizationReport report;
+                            loaded.module = quantizeDynamicInt8(loaded.module, report);
+                            loaded.quantization = report;
+                        }
+                        if (!sharedWeights.empty())
+                        {
+                            shm::shareModuleWeights(loaded.module, sharedWeights);
+                        }
+                        return loaded;
                     },
-                    [=](Napi::Env env, torch::jit::Module value) -> Napi::Value
+                    [=](Napi::Env env, LoadedModule loaded) -> Napi::Value
                     {
-                        return JitModule::FromTorchJitModule(env, value);
+                        auto object = JitModule::FromTorchJitModule(env, loaded.module);
+                        auto wrapped = Napi::ObjectWrap<JitModule>::Unwrap(object);
+                        wrapped->quantization = loaded.quantization;
+                        wrapped->sharedWeights = sharedWeights;
+                        return object;
                     });
 
                 worker->Queue();
@@ -41,6 +125,19 @@ namespace nodeml_torch
             }
         }
 
+        Napi::Value fromShared(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                return JitModule::FromSharedHandle(env, info[0]);
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
         Napi::Object Init(Napi::Env env, Napi::Object exports)
         {
             auto myExports = Napi::Object::New(env);
@@ -48,6 +145,7 @@ namespace nodeml_torch
             JitModule::Init(env, myExports);
 
             myExports.Set("load", Napi::Function::New(env, load));
+            myExports.Set("fromShared", Napi::Function::New(env, fromShared));
 
             exports.Set("jit", myExports);
 
@@ -11,6 +11,7 @@ namespace nodeml_torch
     namespace jit
     {
         Napi::Value load(const Napi::CallbackInfo &info);
+        Napi::Value fromShared(const Napi::CallbackInfo &info);
         Napi::Object Init(Napi::Env env, Napi::Object exports);
     }
 }
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include <addon/jit/quantize.hpp>
+
+#include <ATen/core/dispatch/Dispatcher.h>
+#include <algorithm>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
+
+namespace nodeml_torch
+{
+    namespace jit
+    {
+        // fbgemm on x86, qnnpack on ARM, whichever this libtorch was built with
+        static std::string selectQuantizedEngine()
+        {
+            auto &context = at::globalContext();
+            const auto &engines = context.supportedQEngines();
+
+            for (auto engine : {at::QEngine::FBGEMM, at::QEngine::QNNPACK})
+            {
+                if (std::find(engines.begin(), engines.end(), engine) != engines.end())
+                {
+                    context.setQEngine(engine);
+                    return engine == at::QEngine::FBGEMM ? "fbgemm" : "qnnpack";
+                }
+            }
+
+            throw std::runtime_error("This libtorch build has no quantized engine");
+        }
+
+        static int64_t tensorBytes(const c10::IValue &value)
+        {
+            return value.isTensor() ? int64_t(value.toTensor().nbytes()) : 0;
+        }
+
+        static void quantizeLinears(torch::jit::Block *block, QuantizationReport &report, bool reduceRange)
+        {
+            static const auto linearDynamic = c10::Symbol::fromQualString("quantized::linear_dynamic");
+            auto prepack = c10::Dispatcher::singleton().findSchemaOrThrow("quantized::linear_prepack", "");
+
+            for (auto it = block->nodes().begin(); it != block->nodes().end();)
+            {
+                auto node = *it++;
+
+                for (auto subBlock : node->blocks())
+                {
+                    quantizeLinears(subBlock, report, reduceRange);
+                }
+
+                if (node->kind() != c10::Symbol::fromQualString("aten::linear"))
+                {
+                    continue;
+                }
+
+                auto weightValue = torch::jit::toIValue(node->input(1));
+                auto biasValue = torch::jit::toIValue(node->input(2));
+                if (!weightValue || !biasValue || !weightValue->isTensor() || !(biasValue->isNone() || biasValue->isTensor()))
+                {
+                    continue;
+                }
+
+                auto weight = weightValue->toTensor();
+                if (!weight.is_floating_point() || weight.dim() != 2 || !weight.device().is_cpu())
+                {
+                    continue;
+                }
+
+                // Symmetric per output channel, the zero point stays at 0 for qint8
+                auto floatWeight = weight.to(torch::kFloat).contiguous();
+                auto scales = floatWeight.abs().amax({1}).clamp_min(1e-8).div(127).to(torch::kDouble);
+                auto zeroPoints = torch::zeros({floatWeight.size(0)}, torch::kLong);
+                auto quantizedWeight = at::quantize_per_channel(floatWeight, scales, zeroPoints, 0, torch::kQInt8);
+
+                c10::optional<torch::Tensor> bias;
+                if (biasValue->isTensor())
+                {
+                    bias = biasValue->toTensor().to(torch::kFloat).contiguous();
+                }
+
+                torch::jit::Stack stack{quantizedWeight, bias};
+                prepack.callBoxed(&stack);
+
+                torch::jit::WithInsertPoint guard(node);
+                auto graph = node->owningGraph();
+                auto packed = graph->insertConstant(stack[0]);
+                auto reduce = graph->insertConstant(reduceRange);
+                auto replacement = graph->create(linearDynamic, {node->input(0), packed, reduce}, 1);
+                graph->insertNode(replacement);
+                replacement->output()->setType(node->output()->type());
+                node->output()->replaceAllUsesWith(replacement->output());
+                node->destroy();
+
+                report.linearLayers++;
+                report.bytesAfter -= tensorBytes(*weightValue) + tensorBytes(*biasValue);
+                report.bytesAfter += quantizedWeight.numel() + scales.numel() * 4 + (bias ? int64_t(bias->nbytes()) : 0);
+            }
+        }
+
+        torch::jit::Module quantizeDynamicInt8(const torch::jit::Module &module, QuantizationReport &report)
+        {
+            report.mode = "dynamic-int8";
+            report.engine = selectQuantizedEngine();
+
+            for (const auto &item : module.named_parameters(true))
+            {
+                report.bytesBefore += int64_t(item.value.nbytes());
+            }
+            for (const auto &item : module.named_buffers(true))
+            {
+                report.bytesBefore += int64_t(item.value.nbytes());
+            }
+            report.bytesAfter = report.bytesBefore;
+
+            auto source = module.clone();
+            source.eval();
+            auto frozen = torch::jit::freeze_module(source);
+
+            auto graph = frozen.get_method("forward").graph();
+            // fbgemm activations use 7 bits to stay clear of overflow in the non-VNNI kernels
+            quantizeLinears(graph->block(), report, report.engine == "fbgemm");
+            torch::jit::EliminateDeadCode(graph);
+
+            return frozen;
+        }
+    }
+}
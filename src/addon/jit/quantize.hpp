@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <torch/script.h>
+
+namespace nodeml_torch
+{
+    namespace jit
+    {
+        struct QuantizationReport
+        {
+            std::string mode;
+            std::string engine;
+            int64_t linearLayers = 0;
+            // Parameters and buffers before, constants after, prepacked weights counted at one byte per element
+            int64_t bytesBefore = 0;
+            int64_t bytesAfter = 0;
+        };
+
+        // Freezes the module and swaps every aten::linear with constant float weights for quantized::linear_dynamic,
+        // weights quantized per output channel. Only forward survives freezing
+        torch::jit::Module quantizeDynamicInt8(const torch::jit::Module &module, QuantizationReport &report);
+    }
+}
@@ -0,0 +1,152 @@
+#include <addon/memory/BufferCache.hpp>
+
+#include <c10/core/CPUAllocator.h>
+
+namespace nodeml_torch
+{
+    namespace memory
+    {
+        static void *allocateRaw(size_t bytes)
+        {
+            return c10::GetDefaultCPUAllocator()->raw_allocate(bytes);
+        }
+
+        static void freeRaw(void *ptr)
+        {
+            c10::GetDefaultCPUAllocator()->raw_deallocate(ptr);
+        }
+
+        BufferCache::BufferCache(size_t maxBytes, size_t maxPerClass) : maxBytes(maxBytes), maxPerClass(maxPerClass)
+        {
+        }
+
+        BufferCache::~BufferCache()
+        {
+            clear();
+        }
+
+        size_t BufferCache::sizeClass(size_t bytes)
+        {
+            if (bytes <= 4096)
+            {
+                return std::max<size_t>(64, (bytes + 63) & ~size_t(63));
+            }
+
+            size_t power = 4096;
+            while (power * 2 <= bytes)
+            {
+                power *= 2;
+            }
+
+            auto step = power / 4;
+            return (bytes + step - 1) / step * step;
+        }
+
+        void *BufferCache::acquire(size_t classBytes)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                counters.bytesInUse += classBytes;
+
+                auto found = idle.find(classBytes);
+                if (found != idle.end() && !found->second.empty())
+                {
+                    auto ptr = found->second.back();
+                    found->second.pop_back();
+                    counters.hits++;
+                    counters.buffersCached--;
+                    counters.bytesCached -= classBytes;
+                    return ptr;
+                }
+
+                counters.misses++;
+            }
+
+            try
+            {
+                return allocateRaw(classBytes);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                counters.bytesInUse -= classBytes;
+                throw;
+            }
+        }
+
+        void BufferCache::release(void *ptr, size_t classBytes)
+        {
+            if (ptr == nullptr)
+            {
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                counters.bytesInUse -= classBytes;
+
+                auto &buffers = idle[classBytes];
+                if (buffers.size() < maxPerClass && counters.bytesCached + classBytes <= maxBytes)
+                {
+                    buffers.push_back(ptr);
+                    counters.buffersCached++;
+                    counters.bytesCached += classBytes;
+                    return;
+                }
+
+                counters.evictions++;
+            }
+
+            freeRaw(ptr);
+        }
+
+        void BufferCache::setLimits(size_t newMaxBytes, size_t newMaxPerClass)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            maxBytes = newMaxBytes;
+            maxPerClass = newMaxPerClass;
+            trim();
+        }
+
+        void BufferCache::clear()
+        {
+            std::unordered_map<size_t, std::vector<void *>> released;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                released.swap(idle);
+                counters.buffersCached = 0;
+                counters.bytesCached = 0;
+            }
+
+            for (auto &[classBytes, buffers] : released)
+            {
+                for (auto ptr : buffers)
+                {
+                    freeRaw(ptr);
+                }
+            }
+        }
+
+        BufferCacheStats BufferCache::stats()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return counters;
+        }
+
+        // Called with the mutex held after the limits shrink
+        void BufferCache::trim()
+        {
+            for (auto &[classBytes, buffers] : idle)
+            {
+                while (!buffers.empty() && (buffers.size() > maxPerClass || counters.bytesCached > maxBytes))
+                {
+                    freeRaw(buffers.back());
+                    buffers.pop_back();
+                    counters.buffersCached--;
+                    counters.bytesCached -= classBytes;
+                    counters.evictions++;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace nodeml_torch
+{
+    namespace memory
+    {
+        struct BufferCacheStats
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+            size_t buffersCached = 0;
+            size_t bytesCached = 0;
+            size_t bytesInUse = 0;
+        };
+
+        // Keeps released CPU buffers grouped by size class so same-shaped allocations skip malloc
+        class BufferCache : public std::enable_shared_from_this<BufferCache>
+        {
+        public:
+            BufferCache(size_t maxBytes, size_t maxPerClass);
+
+            ~BufferCache();
+
+            // Rounds up to a class at most 25% larger than the request
+            static size_t sizeClass(size_t bytes);
+
+            void *acquire(size_t classBytes);
+
+            void release(void *ptr, size_t classBytes);
+
+            void setLimits(size_t maxBytes, size_t maxPerClass);
+
+            void clear();
+
+            BufferCacheStats stats();
+
+        private:
+            std::mutex mutex;
+            std::unordered_map<size_t, std::vector<void *>> idle;
+            size_t maxBytes;
+            size_t maxPerClass;
+            BufferCacheStats counters;
+
+            void trim();
+        };
+    }
+}
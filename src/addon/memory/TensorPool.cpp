@@ -0,0 +1,147 @@
+#include <addon/memory/TensorPool.hpp>
+#include <addon/Tensor.hpp>
+#include <addon/utils.hpp>
+
+namespace nodeml_torch
+{
+    namespace memory
+    {
+        static const size_t defaultPoolBytes = size_t(256) << 20;
+        static const size_t defaultPoolBuffersPerClass = 16;
+
+        Napi::Object statsToObject(Napi::Env env, const BufferCacheStats &stats)
+        {
+            auto result = Napi::Object::New(env);
+            result.Set("hits", Napi::Number::New(env, double(stats.hits)));
+            result.Set("misses", Napi::Number::New(env, double(stats.misses)));
+            result.Set("evictions", Napi::Number::New(env, double(stats.evictions)));
+            result.Set("buffersCached", Napi::Number::New(env, double(stats.buffersCached)));
+            result.Set("bytesCached", Napi::Number::New(env, double(stats.bytesCached)));
+            result.Set("bytesInUse", Napi::Number::New(env, double(stats.bytesInUse)));
+            return result;
+        }
+
+        Napi::Object TensorPool::Init(Napi::Env env, Napi::Object exports)
+        {
+            auto func = DefineClass(env, "TensorPool",
+                                    {
+                                        TensorPool::InstanceMethod("empty", &TensorPool::Empty),
+                                        TensorPool::InstanceMethod("zeros", &TensorPool::Zeros),
+                                        TensorPool::InstanceMethod("fromTypedArray", &TensorPool::FromTypedArray),
+                                        TensorPool::InstanceMethod("stats", &TensorPool::Stats),
+                                        TensorPool::InstanceMethod("clear", &TensorPool::Clear),
+                                    });
+
+            exports.Set("TensorPool", func);
+            return exports;
+        }
+
+        TensorPool::TensorPool(const Napi::CallbackInfo &info) : ObjectWrap(info)
+        {
+            auto maxBytes = defaultPoolBytes;
+            auto maxPerClass = defaultPoolBuffersPerClass;
+
+            if (info.Length() > 0 && info[0].IsObject())
+            {
+                auto options = info[0].ToObject();
+
+                if (options.Has("maxBytes"))
+                {
+                    maxBytes = std::max<int64_t>(0, options.Get("maxBytes").ToNumber().Int64Value());
+                }
+
+                if (options.Has("maxPerClass"))
+                {
+                    maxPerClass = std::max<int64_t>(0, options.Get("maxPerClass").ToNumber().Int64Value());
+                }
+            }
+
+            cache = std::make_shared<BufferCache>(maxBytes, maxPerClass);
+        }
+
+        torch::Tensor TensorPool::Allocate(const std::vector<int64_t> &shape, torch::ScalarType dtype)
+        {
+            auto numel = c10::multiply_integers(shape);
+            auto classBytes = BufferCache::sizeClass(numel * c10::elementSize(dtype));
+            auto ptr = cache->acquire(classBytes);
+
+            // The deleter owns the cache too, so buffers outliving the pool object are still released
+            auto owner = cache;
+            return torch::from_blob(
+                ptr, shape, [owner, classBytes](void *data)
+                { owner->release(data, classBytes); },
+                torch::TensorOptions(dtype));
+        }
+
+        Napi::Value TensorPool::Empty(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto shape = utils::napiArrayToVector<int64_t>(info[0].As<Napi::Array>());
+                auto dtype = info.Length() > 1 && info[1].IsString() ? utils::stringToScalarType(info[1].ToString().Utf8Value()) : torch::kFloat32;
+
+                return Tensor::FromTorchTensor(env, Allocate(shape, dtype));
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value TensorPool::Zeros(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                auto shape = utils::napiArrayToVector<int64_t>(info[0].As<Napi::Array>());
+                auto dtype = info.Length() > 1 && info[1].IsString() ? utils::stringToScalarType(info[1].ToString().Utf8Value()) : torch::kFloat32;
+
+                return Tensor::FromTorchTensor(env, Allocate(shape, dtype).zero_());
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value TensorPool::FromTypedArray(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                if (!info[0].IsTypedArray())
+                {
+                    throw Napi::Error::New(env, "Expected A TypedArray");
+                }
+
+                // Same conversions as Tensor.fromTypedArray, only the destination comes from the pool
+                auto data = info[0].As<Napi::TypedArray>();
+                auto shape = info.Length() > 1 && info[1].IsArray() ? shapeForArray(data, info[1].As<Napi::Array>())
+                                                                    : std::vector<int64_t>{int64_t(data.ElementLength())};
+                auto dtype = info.Length() > 2 && info[2].IsString() ? utils::stringToScalarType(info[2].ToString().Utf8Value())
+                                                                     : typedArrayScalarType(env, data);
+
+                auto tensor = Allocate(shape, dtype);
+                copyTypedArray(env, data, tensor);
+
+                return Tensor::FromTorchTensor(env, tensor);
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value TensorPool::Stats(const Napi::CallbackInfo &info)
+        {
+            return statsToObject(info.Env(), cache->stats());
+        }
+
+        Napi::Value TensorPool::Clear(const Napi::CallbackInfo &info)
+        {
+            cache->clear();
+            return info.Env().Undefined();
+        }
+    }
+}
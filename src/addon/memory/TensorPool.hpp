@@ -0,0 +1,39 @@
+#pragma once
+
+#include <napi.h>
+
+#include <addon/memory/BufferCache.hpp>
+#include <memory>
+#include <torch/torch.h>
+
+namespace nodeml_torch
+{
+    namespace memory
+    {
+        Napi::Object statsToObject(Napi::Env env, const BufferCacheStats &stats);
+
+        // Hands out tensors whose storage goes back to the pool once every tensor sharing it is gone
+        class TensorPool : public Napi::ObjectWrap<TensorPool>
+        {
+
+        public:
+            std::shared_ptr<BufferCache> cache;
+
+            static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+            TensorPool(const Napi::CallbackInfo &info);
+
+            torch::Tensor Allocate(const std::vector<int64_t> &shape, torch::ScalarType dtype);
+
+            Napi::Value Empty(const Napi::CallbackInfo &info);
+
+            Napi::Value Zeros(const Napi::CallbackInfo &info);
+
+            Napi::Value FromTypedArray(const Napi::CallbackInfo &info);
+
+            Napi::Value Stats(const Napi::CallbackInfo &info);
+
+            Napi::Value Clear(const Napi::CallbackInfo &info);
+        };
+    }
+}
@@ -0,0 +1,193 @@
+#include <addon/memory/allocator.hpp>
+#include <addon/memory/BufferCache.hpp>
+#include <addon/memory/TensorPool.hpp>
+
+#include <atomic>
+#include <c10/core/CPUAllocator.h>
+#include <mutex>
+
+namespace nodeml_torch
+{
+    namespace memory
+    {
+        namespace allocator
+        {
+            static const size_t defaultAllocatorBytes = size_t(512) << 20;
+            static const size_t defaultAllocatorBuffersPerClass = 16;
+            static const size_t defaultMinBytes = size_t(64) << 10;
+
+            // Sits in front of every block so a data pointer alone finds its way back.
+            // c10 expects data == context and a real raw_deleter, the header keeps the data 64 byte aligned
+            struct alignas(64) BlockHeader
+            {
+                // 0 for blocks below minBytes, which bypass the cache
+                size_t classBytes;
+            };
+
+            static std::shared_ptr<BufferCache> &blockCache()
+            {
+                // Never freed for the same reason as the allocator itself
+                static auto *cache = new std::shared_ptr<BufferCache>();
+                return *cache;
+            }
+
+            static void releaseBlock(void *data)
+            {
+                auto header = static_cast<BlockHeader *>(data) - 1;
+                if (header->classBytes == 0)
+                {
+                    c10::GetDefaultCPUAllocator()->raw_deallocate(header);
+                }
+                else
+                {
+                    blockCache()->release(header, header->classBytes);
+                }
+            }
+
+            // Routes every CPU allocation above minBytes through a BufferCache, smaller ones go straight to the default allocator
+            class CachingCPUAllocator final : public c10::Allocator
+            {
+            public:
+                std::shared_ptr<BufferCache> cache;
+                std::atomic<size_t> minBytes;
+
+                CachingCPUAllocator(size_t maxBytes, size_t maxPerClass, size_t minBytes)
+                    : cache(std::make_shared<BufferCache>(maxBytes, maxPerClass)), minBytes(minBytes)
+                {
+                    blockCache() = cache;
+                }
+
+                c10::DataPtr allocate(size_t bytes) const override
+                {
+                    BlockHeader *header;
+
+                    if (bytes < minBytes)
+                    {
+                        header = static_cast<BlockHeader *>(c10::GetDefaultCPUAllocator()->raw_allocate(bytes + sizeof(BlockHeader)));
+                        header->classBytes = 0;
+                    }
+                    else
+                    {
+                        auto classBytes = BufferCache::sizeClass(bytes + sizeof(BlockHeader));
+                        header = static_cast<BlockHeader *>(cache->acquire(classBytes));
+                        header->classBytes = classBytes;
+                    }
+
+                    auto data = static_cast<void *>(header + 1);
+                    return {data, data, &releaseBlock, c10::Device(c10::DeviceType::CPU)};
+                }
+
+                c10::DeleterFnPtr raw_deleter() const override
+                {
+                    return &releaseBlock;
+                }
+            };
+
+            // Never freed, tensors allocated through it may outlive any addon instance
+            static CachingCPUAllocator *cachingAllocator = nullptr;
+            static c10::Allocator *previousAllocator = nullptr;
+            static std::mutex allocatorMutex;
+
+            Napi::Value enable(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    auto maxBytes = defaultAllocatorBytes;
+                    auto maxPerClass = defaultAllocatorBuffersPerClass;
+                    auto minBytes = defaultMinBytes;
+
+                    if (info.Length() > 0 && info[0].IsObject())
+                    {
+                        auto options = info[0].ToObject();
+
+                        if (options.Has("maxBytes"))
+                        {
+                            maxBytes = std::max<int64_t>(0, options.Get("maxBytes").ToNumber().Int64Value());
+                        }
+
+                        if (options.Has("maxPerClass"))
+                        {
+                            maxPerClass = std::max<int64_t>(0, options.Get("maxPerClass").ToNumber().Int64Value());
+                        }
+
+                        if (options.Has("minBytes"))
+                        {
+                            minBytes = std::max<int64_t>(0, options.Get("minBytes").ToNumber().Int64Value());
+                        }
+                    }
+
+                    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+                    if (cachingAllocator == nullptr)
+                    {
+                        cachingAllocator = new CachingCPUAllocator(maxBytes, maxPerClass, minBytes);
+                    }
+                    else
+                    {
+                        cachingAllocator->cache->setLimits(maxBytes, maxPerClass);
+                        cachingAllocator->minBytes = minBytes;
+                    }
+
+                    if (c10::GetCPUAllocator() != cachingAllocator)
+                    {
+                        previousAllocator = c10::GetCPUAllocator();
+                        c10::SetCPUAllocator(cachingAllocator, 1);
+                    }
+
+                    return env.Undefined();
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Value disable(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+                    if (cachingAllocator != nullptr && c10::GetCPUAllocator() == cachingAllocator)
+                    {
+                        c10::SetCPUAllocator(previousAllocator, 1);
+
+                        // Buffers still held by live tensors are freed as soon as they are released
+                        cachingAllocator->cache->setLimits(0, 0);
+                    }
+
+                    return env.Undefined();
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Value stats(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                std::lock_guard<std::mutex> lock(allocatorMutex);
+
+                auto result = statsToObject(env, cachingAllocator != nullptr ? cachingAllocator->cache->stats() : BufferCacheStats());
+                result.Set("enabled", Napi::Boolean::New(env, cachingAllocator != nullptr && c10::GetCPUAllocator() == cachingAllocator));
+                return result;
+            }
+
+            Napi::Object Init(Napi::Env env, Napi::Object exports)
+            {
+                auto myExports = Napi::Object::New(env);
+
+                myExports.Set("enable", Napi::Function::New(env, enable));
+                myExports.Set("disable", Napi::Function::New(env, disable));
+                myExports.Set("stats", Napi::Function::New(env, stats));
+
+                exports.Set("allocator", myExports);
+
+                return exports;
+            }
+        }
+    }
+}
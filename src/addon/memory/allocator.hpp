@@ -0,0 +1,20 @@
+#pragma once
+
+#include <napi.h>
+
+namespace nodeml_torch
+{
+    namespace memory
+    {
+        namespace allocator
+        {
+            Napi::Value enable(const Napi::CallbackInfo &info);
+
+            Napi::Value disable(const Napi::CallbackInfo &info);
+
+            Napi::Value stats(const Napi::CallbackInfo &info);
+
+            Napi::Object Init(Napi::Env env, Napi::Object exports);
+        }
+    }
+}
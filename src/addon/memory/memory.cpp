@@ -0,0 +1,17 @@
+#include <addon/memory/memory.hpp>
+#include <addon/memory/TensorPool.hpp>
+#include <addon/memory/allocator.hpp>
+
+namespace nodeml_torch
+{
+    namespace memory
+    {
+        Napi::Object Init(Napi::Env env, Napi::Object exports)
+        {
+            TensorPool::Init(env, exports);
+            allocator::Init(env, exports);
+
+            return exports;
+        }
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <napi.h>
+
+namespace nodeml_torch
+{
+    namespace memory
+    {
+        Napi::Object Init(Napi::Env env, Napi::Object exports);
+    }
+}
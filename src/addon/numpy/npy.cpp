@@ -0,0 +1,221 @@
+#include <addon/numpy/npy.hpp>
+
+#include <algorithm>
+#include <c10/util/safe_numerics.h>
+#include <cstring>
+
+namespace nodeml_torch
+{
+    namespace numpy
+    {
+        static const char npyMagic[] = "\x93NUMPY";
+        static const size_t npyMagicLength = 6;
+
+        static torch::ScalarType dtypeFromDescr(const std::string &code)
+        {
+            static const std::vector<std::pair<std::string, torch::ScalarType>> dtypes = {
+                {"f2", torch::kHalf}, {"f4", torch::kFloat}, {"f8", torch::kDouble}, {"i1", torch::kChar}, {"i2", torch::kShort}, {"i4", torch::kInt}, {"i8", torch::kLong}, {"u1", torch::kByte}, {"b1", torch::kBool}};
+
+            for (const auto &[name, type] : dtypes)
+            {
+                if (name == code)
+                {
+                    return type;
+                }
+            }
+
+            throw std::invalid_argument("Unsupported numpy dtype " + code);
+        }
+
+        static std::string descrFromDtype(torch::ScalarType dtype)
+        {
+            switch (dtype)
+            {
+            case torch::kHalf:
+                return "<f2";
+            case torch::kFloat:
+                return "<f4";
+            case torch::kDouble:
+                return "<f8";
+            case torch::kChar:
+                return "|i1";
+            case torch::kShort:
+                return "<i2";
+            case torch::kInt:
+                return "<i4";
+            case torch::kLong:
+                return "<i8";
+            case torch::kByte:
+                return "|u1";
+            case torch::kBool:
+                return "|b1";
+            default:
+                throw std::invalid_argument(std::string("numpy has no dtype for ") + c10::toString(dtype));
+            }
+        }
+
+        // The header is a Python dict literal, numpy always writes the three keys below
+        static size_t findValue(const std::string &header, const std::string &key)
+        {
+            auto at = header.find("'" + key + "'");
+            if (at == std::string::npos)
+            {
+                throw std::runtime_error("npy header has no " + key);
+            }
+            at = header.find(':', at);
+            if (at == std::string::npos)
+            {
+                throw std::runtime_error("Invalid npy header");
+            }
+            at = header.find_first_not_of(" ", at + 1);
+            if (at == std::string::npos)
+            {
+                throw std::runtime_error("npy header has no value for " + key);
+            }
+            return at;
+        }
+
+        torch::Tensor tensorFromNpy(const ByteSource &source)
+        {
+            if (source.size < 10 || std::memcmp(source.data, npyMagic, npyMagicLength) != 0)
+            {
+                throw std::runtime_error("Not a .npy array");
+            }
+
+            auto major = source.data[6];
+            size_t headerStart = major == 1 ? 10 : 12;
+            if (source.size < headerStart)
+            {
+                throw std::runtime_error("Truncated .npy array");
+            }
+
+            size_t headerLength = major == 1 ? source.data[8] | (source.data[9] << 8)
+                                             : source.data[8] | (source.data[9] << 8) | (source.data[10] << 16) | (size_t(source.data[11]) << 24);
+            if (headerStart + headerLength > source.size)
+            {
+                throw std::runtime_error("Truncated .npy header");
+            }
+
+            auto header = std::string(reinterpret_cast<const char *>(source.data + headerStart), headerLength);
+
+            auto descrAt = findValue(header, "descr");
+            auto descrEnd = header.find(header[descrAt], descrAt + 1);
+            if (descrEnd == std::string::npos || descrEnd - descrAt < 3)
+            {
+                throw std::runtime_error("Invalid npy descr");
+            }
+            auto descr = header.substr(descrAt + 1, descrEnd - descrAt - 1);
+            auto byteOrder = descr[0];
+            auto dtype = dtypeFromDescr(descr.substr(1));
+            auto itemSize = c10::elementSize(dtype);
+            auto swap = byteOrder == '>' && itemSize > 1;
+
+            auto fortranOrder = header.compare(findValue(header, "fortran_order"), 4, "True") == 0;
+
+            auto shapeAt = findValue(header, "shape");
+            auto shapeEnd = header.find(')', shapeAt);
+            if (header[shapeAt] != '(' || shapeEnd == std::string::npos)
+            {
+                throw std::runtime_error("Invalid npy shape");
+            }
+
+            std::vector<int64_t> shape;
+            auto dims = header.substr(shapeAt + 1, shapeEnd - shapeAt - 1);
+            size_t pos = 0;
+            while (pos < dims.size())
+            {
+                auto next = dims.find(',', pos);
+                auto token = dims.substr(pos, next == std::string::npos ? std::string::npos : next - pos);
+                if (token.find_first_not_of(" ") != std::string::npos)
+                {
+                    shape.push_back(std::stoll(token));
+                    if (shape.back() < 0)
+                    {
+                        throw std::runtime_error("Invalid npy shape");
+                    }
+                }
+                if (next == std::string::npos)
+                {
+                    break;
+                }
+                pos = next + 1;
+            }
+
+            auto dataOffset = headerStart + headerLength;
+            uint64_t numel = 0;
+            uint64_t bytes = 0;
+            if (c10::safe_multiplies_u64(shape, &numel) || c10::mul_overflows(numel, uint64_t(itemSize), &bytes) || bytes > source.size - dataOffset)
+            {
+                throw std::runtime_error("Truncated .npy data");
+            }
+
+            // Fortran order is C order of the reversed shape
+            auto storageShape = shape;
+            if (fortranOrder)
+            {
+                std::reverse(storageShape.begin(), storageShape.end());
+            }
+
+            auto data = source.data + dataOffset;
+            auto owner = source.owner;
+            torch::Tensor tensor;
+
+            if (!swap && reinterpret_cast<uintptr_t>(data) % itemSize == 0)
+            {
+                tensor = torch::from_blob(
+                    const_cast<uint8_t *>(data), storageShape, [owner](void *) {}, torch::TensorOptions(dtype));
+            }
+            else
+            {
+                tensor = torch::empty(storageShape, torch::TensorOptions(dtype));
+                std::memcpy(tensor.data_ptr(), data, bytes);
+                if (swap)
+                {
+                    auto flat = tensor.view({-1}).view(torch::kByte).view({-1, int64_t(itemSize)});
+                    flat.copy_(flat.flip({1}));
+                }
+            }
+
+            if (fortranOrder)
+            {
+                std::vector<int64_t> order(shape.size());
+                for (size_t i = 0; i < order.size(); i++)
+                {
+                    order[i] = int64_t(order.size() - 1 - i);
+                }
+                tensor = tensor.permute(order);
+            }
+
+            return tensor;
+        }
+
+        std::string npyHeader(const torch::Tensor &tensor)
+        {
+            std::string dict = "{'descr': '" + descrFromDtype(tensor.scalar_type()) + "', 'fortran_order': False, 'shape': (";
+            for (int64_t i = 0; i < tensor.dim(); i++)
+            {
+                dict += std::to_string(tensor.size(i)) + (tensor.dim() == 1 || i + 1 < tensor.dim() ? "," : "");
+                if (i + 1 < tensor.dim())
+                {
+                    dict += " ";
+                }
+            }
+            dict += "), }";
+
+            auto large = dict.size() + 1 + 10 > 65535;
+            size_t prefixLength = large ? 12 : 10;
+            dict.append((64 - (prefixLength + dict.size() + 1) % 64) % 64, ' ');
+            dict += '\n';
+
+            std::string header(npyMagic, npyMagicLength);
+            header += char(large ? 2 : 1);
+            header += char(0);
+            for (size_t i = 0; i < (large ? 4 : 2); i++)
+            {
+                header += char(uint8_t(dict.size() >> (8 * i)));
+            }
+
+            return header + dict;
+        }
+    }
+}
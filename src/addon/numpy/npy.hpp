@@ -0,0 +1,26 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <torch/torch.h>
+
+namespace nodeml_torch
+{
+    namespace numpy
+    {
+        // Bytes arrays are read from, tensors viewing them keep owner alive
+        struct ByteSource
+        {
+            const uint8_t *data = nullptr;
+            size_t size = 0;
+            std::shared_ptr<void> owner;
+        };
+
+        // Views the array data in place unless it is misaligned or big endian. Fortran ordered
+        // arrays come back as a permuted, non contiguous view
+        torch::Tensor tensorFromNpy(const ByteSource &source);
+
+        // Everything written before the data of a C ordered array, padded to 64 bytes
+        std::string npyHeader(const torch::Tensor &tensor);
+    }
+}
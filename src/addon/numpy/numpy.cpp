@@ -0,0 +1,269 @@
+#include <addon/numpy/numpy.hpp>
+#include <addon/numpy/npy.hpp>
+#include <addon/numpy/zip.hpp>
+#include <addon/FunctionWorker.hpp>
+#include <addon/MappedFile.hpp>
+#include <addon/SharedTensor.hpp>
+#include <addon/Tensor.hpp>
+
+#include <cstring>
+#include <fstream>
+
+namespace nodeml_torch
+{
+    namespace numpy
+    {
+        struct LoadResult
+        {
+            // .npz archives resolve to an object keyed by array name
+            bool archive = false;
+            std::vector<std::pair<std::string, torch::Tensor>> tensors;
+        };
+
+        static const std::string npySuffix = ".npy";
+
+        static ByteSource readFile(const std::string &path, bool mmap)
+        {
+            ByteSource source;
+
+            if (mmap)
+            {
+                auto file = MappedFile::Open(path);
+                source.data = file->data();
+                source.size = file->size();
+                source.owner = file;
+                return source;
+            }
+
+            std::ifstream stream(path, std::ios::binary | std::ios::ate);
+            if (!stream)
+            {
+                throw std::runtime_error("Could not open " + path);
+            }
+
+            auto contents = std::make_shared<std::vector<uint8_t>>(size_t(stream.tellg()));
+            stream.seekg(0);
+            if (!stream.read(reinterpret_cast<char *>(contents->data()), std::streamsize(contents->size())))
+            {
+                throw std::runtime_error("Could not read " + path);
+            }
+
+            source.data = contents->data();
+            source.size = contents->size();
+            source.owner = contents;
+            return source;
+        }
+
+        static LoadResult loadSource(const ByteSource &source)
+        {
+            LoadResult result;
+
+            if (source.size < 4 || std::memcmp(source.data, "PK", 2) != 0)
+            {
+                result.tensors.emplace_back("", tensorFromNpy(source));
+                return result;
+            }
+
+            result.archive = true;
+            for (const auto &entry : readZipDirectory(source.data, source.size))
+            {
+                if (entry.name.size() <= npySuffix.size() || entry.name.compare(entry.name.size() - npySuffix.size(), npySuffix.size(), npySuffix) != 0)
+                {
+                    continue;
+                }
+
+                ByteSource member;
+                if (entry.method == 0)
+                {
+                    // Only compressedSize is range checked against the archive
+                    if (entry.compressedSize != entry.uncompressedSize)
+                    {
+                        throw std::runtime_error("Corrupt zip entry " + entry.name + ", stored sizes disagree");
+                    }
+                    member.data = source.data + entry.dataOffset;
+                    member.size = entry.compressedSize;
+                    member.owner = source.owner;
+                }
+                else if (entry.method == 8)
+                {
+                    auto contents = std::make_shared<std::vector<uint8_t>>(entry.uncompressedSize);
+                    inflateRaw(source.data + entry.dataOffset, entry.compressedSize, contents->data(), contents->size());
+                    member.data = contents->data();
+                    member.size = contents->size();
+                    member.owner = contents;
+                }
+                else
+                {
+                    throw std::runtime_error("Unsupported zip compression for " + entry.name);
+                }
+
+                result.tensors.emplace_back(entry.name.substr(0, entry.name.size() - npySuffix.size()), tensorFromNpy(member));
+            }
+
+            return result;
+        }
+
+        Napi::Value load(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                bool mmap = true;
+                if (info.Length() > 1 && info[1].IsObject() && info[1].ToObject().Has("mmap"))
+                {
+                    mmap = info[1].ToObject().Get("mmap").ToBoolean().Value();
+                }
+
+                std::string path;
+                ByteSource source;
+
+                if (info[0].IsString())
+                {
+                    path = info[0].ToString().Utf8Value();
+                }
+                else if (info[0].IsTypedArray())
+                {
+                    // Arrays view the caller's buffer, which stays referenced until the last tensor is freed
+                    auto array = info[0].As<Napi::TypedArray>();
+                    auto queue = ReleaseQueue::ForEnv(env);
+                    source.data = static_cast<const uint8_t *>(array.ArrayBuffer().Data()) + array.ByteOffset();
+                    source.size = array.ByteLength();
+                    source.owner = std::shared_ptr<Napi::ObjectReference>(new Napi::ObjectReference(Napi::Persistent(array.ToObject())),
+                                                                          [queue](Napi::ObjectReference *reference)
+                                                                          { queue->Release(reference); });
+                }
+                else
+                {
+                    throw Napi::Error::New(env, "Expected A Path Or A Buffer");
+                }
+
+                auto worker = new FunctionWorker<LoadResult>(
+                    env,
+                    [=]() -> LoadResult
+                    {
+                        return loadSource(path.empty() ? source : readFile(path, mmap));
+                    },
+                    [=](Napi::Env env, LoadResult result) -> Napi::Value
+                    {
+                        if (!result.archive)
+                        {
+                            return Tensor::FromTorchTensor(env, result.tensors[0].second);
+                        }
+
+                        auto arrays = Napi::Object::New(env);
+                        for (const auto &[name, tensor] : result.tensors)
+                        {
+                            arrays.Set(name, Tensor::FromTorchTensor(env, tensor));
+                        }
+                        return arrays;
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value save(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                if (!info[0].IsString())
+                {
+                    throw Napi::Error::New(env, "Path Must Be A String");
+                }
+
+                if (!info[1].IsObject())
+                {
+                    throw Napi::Error::New(env, "Expected A Tensor Or An Object Of Tensors");
+                }
+
+                auto path = info[0].ToString().Utf8Value();
+                auto value = info[1].ToObject();
+                bool archive = !Tensor::IsInstance(value);
+                bool compress = false;
+                std::vector<std::pair<std::string, torch::Tensor>> tensors;
+
+                if (info.Length() > 2 && info[2].IsObject() && info[2].ToObject().Has("compress"))
+                {
+                    compress = info[2].ToObject().Get("compress").ToBoolean().Value();
+                }
+
+                if (!archive)
+                {
+                    tensors.emplace_back("", Tensor::FromObject(value)->torchTensor);
+                }
+                else
+                {
+                    auto keys = value.GetPropertyNames();
+                    for (uint32_t i = 0; i < keys.Length(); i++)
+                    {
+                        auto name = keys.Get(i).ToString().Utf8Value();
+                        auto item = value.Get(name);
+                        if (!item.IsObject() || !Tensor::IsInstance(item.ToObject()))
+                        {
+                            throw Napi::Error::New(env, name + " Is Not A Tensor");
+                        }
+                        tensors.emplace_back(name, Tensor::FromObject(item)->torchTensor);
+                    }
+                }
+
+                auto worker = new FunctionWorker<bool>(
+                    env,
+                    [=]() -> bool
+                    {
+                        if (!archive)
+                        {
+                            auto tensor = tensors[0].second.cpu().contiguous();
+                            auto header = npyHeader(tensor);
+
+                            std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+                            stream.write(header.data(), std::streamsize(header.size()));
+                            stream.write(static_cast<const char *>(tensor.data_ptr()), std::streamsize(tensor.nbytes()));
+                            if (!stream.flush())
+                            {
+                                throw std::runtime_error("Could not write " + path);
+                            }
+                            return true;
+                        }
+
+                        ZipWriter writer(path);
+                        for (const auto &[name, item] : tensors)
+                        {
+                            auto tensor = item.cpu().contiguous();
+                            writer.add(name + npySuffix, npyHeader(tensor), static_cast<const uint8_t *>(tensor.data_ptr()), tensor.nbytes(), compress);
+                        }
+                        writer.finish();
+                        return true;
+                    },
+                    [=](Napi::Env env, bool) -> Napi::Value
+                    {
+                        return env.Undefined();
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Object Init(Napi::Env env, Napi::Object exports)
+        {
+            auto myExports = Napi::Object::New(env);
+
+            myExports.Set("load", Napi::Function::New(env, load));
+            myExports.Set("save", Napi::Function::New(env, save));
+
+            exports.Set("numpy", myExports);
+
+            return exports;
+        }
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <napi.h>
+
+namespace nodeml_torch
+{
+    namespace numpy
+    {
+        Napi::Value load(const Napi::CallbackInfo &info);
+
+        Napi::Value save(const Napi::CallbackInfo &info);
+
+        Napi::Object Init(Napi::Env env, Napi::Object exports);
+    }
+}
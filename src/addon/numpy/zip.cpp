@@ -0,0 +1,358 @@
+#include <addon/numpy/zip.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace nodeml_torch
+{
+    namespace numpy
+    {
+        static const uint32_t localHeaderSignature = 0x04034b50;
+        static const uint32_t centralHeaderSignature = 0x02014b50;
+        static const uint32_t endOfDirectorySignature = 0x06054b50;
+        static const uint32_t zip64LocatorSignature = 0x07064b50;
+        static const uint32_t zip64EndOfDirectorySignature = 0x06064b50;
+
+        static uint64_t readLE(const uint8_t *bytes, int count)
+        {
+            uint64_t value = 0;
+            for (int i = count - 1; i >= 0; i--)
+            {
+                value = (value << 8) | bytes[i];
+            }
+            return value;
+        }
+
+        static void appendLE(std::string &out, uint64_t value, int count)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                out += char(uint8_t(value >> (8 * i)));
+            }
+        }
+
+        static void checkRange(uint64_t offset, uint64_t length, size_t size)
+        {
+            if (offset > size || length > size - offset)
+            {
+                throw std::runtime_error("Corrupt zip archive");
+            }
+        }
+
+        std::vector<ZipEntry> readZipDirectory(const uint8_t *data, size_t size)
+        {
+            // The end record sits in the last 22 bytes plus at most 64KB of comment
+            if (size < 22)
+            {
+                throw std::runtime_error("Corrupt zip archive");
+            }
+
+            int64_t end = -1;
+            auto lowest = size > 22 + 65535 ? int64_t(size - 22 - 65535) : 0;
+            for (auto pos = int64_t(size - 22); pos >= lowest; pos--)
+            {
+                if (readLE(data + pos, 4) == endOfDirectorySignature)
+                {
+                    end = pos;
+                    break;
+                }
+            }
+
+            if (end < 0)
+            {
+                throw std::runtime_error("Not a zip archive");
+            }
+
+            uint64_t count = readLE(data + end + 10, 2);
+            uint64_t directoryOffset = readLE(data + end + 16, 4);
+
+            if ((count == 0xFFFF || directoryOffset == 0xFFFFFFFF) && end >= 20 && readLE(data + end - 20, 4) == zip64LocatorSignature)
+            {
+                auto record = readLE(data + end - 20 + 8, 8);
+                checkRange(record, 56, size);
+                if (readLE(data + record, 4) != zip64EndOfDirectorySignature)
+                {
+                    throw std::runtime_error("Corrupt zip64 archive");
+                }
+                count = readLE(data + record + 32, 8);
+                directoryOffset = readLE(data + record + 48, 8);
+            }
+
+            std::vector<ZipEntry> entries;
+            auto pos = directoryOffset;
+            for (uint64_t i = 0; i < count; i++)
+            {
+                checkRange(pos, 46, size);
+                if (readLE(data + pos, 4) != centralHeaderSignature)
+                {
+                    throw std::runtime_error("Corrupt zip central directory");
+                }
+
+                ZipEntry entry;
+                entry.method = uint16_t(readLE(data + pos + 10, 2));
+                entry.crc = uint32_t(readLE(data + pos + 16, 4));
+                entry.compressedSize = readLE(data + pos + 20, 4);
+                entry.uncompressedSize = readLE(data + pos + 24, 4);
+                auto nameLength = readLE(data + pos + 28, 2);
+                auto extraLength = readLE(data + pos + 30, 2);
+                auto commentLength = readLE(data + pos + 32, 2);
+                uint64_t localOffset = readLE(data + pos + 42, 4);
+
+                checkRange(pos + 46, nameLength + extraLength + commentLength, size);
+                entry.name = std::string(reinterpret_cast<const char *>(data + pos + 46), nameLength);
+
+                // Zip64 extra fields only carry the values whose 32 bit slot is saturated, in this order
+                auto extra = data + pos + 46 + nameLength;
+                for (uint64_t at = 0; at + 4 <= extraLength;)
+                {
+                    auto id = readLE(extra + at, 2);
+                    auto length = readLE(extra + at + 2, 2);
+                    // A field running past the extra block is corrupt, nothing after it can be trusted
+                    if (at + 4 + length > extraLength)
+                    {
+                        break;
+                    }
+                    if (id == 0x0001)
+                    {
+                        auto field = extra + at + 4;
+                        auto fieldEnd = std::min(field + length, extra + extraLength);
+                        if (entry.uncompressedSize == 0xFFFFFFFF && field + 8 <= fieldEnd)
+                        {
+                            entry.uncompressedSize = readLE(field, 8);
+                            field += 8;
+                        }
+                        if (entry.compressedSize == 0xFFFFFFFF && field + 8 <= fieldEnd)
+                        {
+                            entry.compressedSize = readLE(field, 8);
+                            field += 8;
+                        }
+                        if (localOffset == 0xFFFFFFFF && field + 8 <= fieldEnd)
+                        {
+                            localOffset = readLE(field, 8);
+                        }
+                    }
+                    at += 4 + length;
+                }
+
+                checkRange(localOffset, 30, size);
+                if (readLE(data + localOffset, 4) != localHeaderSignature)
+                {
+                    throw std::runtime_error("Corrupt zip local header for " + entry.name);
+                }
+                entry.dataOffset = localOffset + 30 + readLE(data + localOffset + 26, 2) + readLE(data + localOffset + 28, 2);
+                checkRange(entry.dataOffset, entry.compressedSize, size);
+
+                entries.push_back(entry);
+                pos += 46 + nameLength + extraLength + commentLength;
+            }
+
+            return entries;
+        }
+
+        void inflateRaw(const uint8_t *in, size_t inSize, uint8_t *out, size_t outSize)
+        {
+            z_stream stream;
+            std::memset(&stream, 0, sizeof(stream));
+            if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+            {
+                throw std::runtime_error("Could not initialize zlib");
+            }
+
+            // zlib counts in uInt, large entries are fed in chunks
+            const size_t chunk = std::numeric_limits<uInt>::max();
+            int status = Z_OK;
+            size_t consumed = 0, produced = 0;
+            while (status == Z_OK)
+            {
+                stream.next_in = const_cast<Bytef *>(in + consumed);
+                stream.avail_in = uInt(std::min(chunk, inSize - consumed));
+                stream.next_out = out + produced;
+                stream.avail_out = uInt(std::min(chunk, outSize - produced));
+
+                auto availIn = stream.avail_in, availOut = stream.avail_out;
+                status = inflate(&stream, Z_NO_FLUSH);
+                consumed += availIn - stream.avail_in;
+                produced += availOut - stream.avail_out;
+
+                if (status == Z_OK && availIn == stream.avail_in && availOut == stream.avail_out)
+                {
+                    break;
+                }
+            }
+            inflateEnd(&stream);
+
+            if (status != Z_STREAM_END || produced != outSize)
+            {
+                throw std::runtime_error("Corrupt deflate stream in zip archive");
+            }
+        }
+
+        static uint32_t crc32Of(uint32_t crc, const uint8_t *data, size_t size)
+        {
+            const size_t chunk = std::numeric_limits<uInt>::max();
+            for (size_t done = 0; done < size; done += chunk)
+            {
+                crc = uint32_t(crc32(crc, data + done, uInt(std::min(chunk, size - done))));
+            }
+            return crc;
+        }
+
+        static std::vector<uint8_t> deflateRaw(const std::string &prefix, const uint8_t *data, size_t size)
+        {
+            z_stream stream;
+            std::memset(&stream, 0, sizeof(stream));
+            if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            {
+                throw std::runtime_error("Could not initialize zlib");
+            }
+
+            std::vector<uint8_t> out(deflateBound(&stream, uLong(prefix.size() + size)) + 64);
+            const size_t chunk = std::numeric_limits<uInt>::max();
+            size_t produced = 0;
+
+            auto feed = [&](const uint8_t *in, size_t inSize, int flush)
+            {
+                size_t consumed = 0;
+                int status;
+                do
+                {
+                    if (out.size() - produced < 64)
+                    {
+                        out.resize(out.size() * 2);
+                    }
+                    stream.next_in = const_cast<Bytef *>(in + consumed);
+                    stream.avail_in = uInt(std::min(chunk, inSize - consumed));
+                    stream.next_out = out.data() + produced;
+                    stream.avail_out = uInt(std::min(chunk, out.size() - produced));
+
+                    auto availIn = stream.avail_in, availOut = stream.avail_out;
+                    auto last = consumed + availIn == inSize;
+                    status = deflate(&stream, last ? flush : Z_NO_FLUSH);
+                    consumed += availIn - stream.avail_in;
+                    produced += availOut - stream.avail_out;
+                } while (consumed < inSize || (flush == Z_FINISH && status != Z_STREAM_END));
+            };
+
+            feed(reinterpret_cast<const uint8_t *>(prefix.data()), prefix.size(), Z_NO_FLUSH);
+            feed(data, size, Z_FINISH);
+            deflateEnd(&stream);
+
+            out.resize(produced);
+            return out;
+        }
+
+        ZipWriter::ZipWriter(const std::string &path) : path(path), stream(path, std::ios::binary | std::ios::trunc)
+        {
+            if (!stream)
+            {
+                throw std::runtime_error("Could not open " + path + " for writing");
+            }
+        }
+
+        void ZipWriter::write(const void *data, size_t size)
+        {
+            stream.write(static_cast<const char *>(data), std::streamsize(size));
+            offset += size;
+        }
+
+        void ZipWriter::add(const std::string &name, const std::string &prefix, const uint8_t *data, size_t size, bool compress)
+        {
+            ZipEntry entry;
+            entry.name = name;
+            entry.method = compress ? 8 : 0;
+            entry.uncompressedSize = prefix.size() + size;
+            entry.crc = crc32Of(crc32Of(0, reinterpret_cast<const uint8_t *>(prefix.data()), prefix.size()), data, size);
+
+            std::vector<uint8_t> compressed;
+            if (compress)
+            {
+                compressed = deflateRaw(prefix, data, size);
+            }
+            entry.compressedSize = compress ? compressed.size() : entry.uncompressedSize;
+
+            if (entry.compressedSize >= 0xFFFFFFFF || entry.uncompressedSize >= 0xFFFFFFFF || offset >= 0xFFFFFFFF)
+            {
+                throw std::runtime_error("Arrays past 4GB can not be written to .npz");
+            }
+
+            std::string header;
+            appendLE(header, localHeaderSignature, 4);
+            appendLE(header, 20, 2);
+            appendLE(header, 0, 2);
+            appendLE(header, entry.method, 2);
+            appendLE(header, 0, 4);
+            appendLE(header, entry.crc, 4);
+            appendLE(header, entry.compressedSize, 4);
+            appendLE(header, entry.uncompressedSize, 4);
+            appendLE(header, name.size(), 2);
+            appendLE(header, 0, 2);
+            header += name;
+
+            localOffsets.push_back(offset);
+            write(header.data(), header.size());
+            if (compress)
+            {
+                write(compressed.data(), compressed.size());
+            }
+            else
+            {
+                write(prefix.data(), prefix.size());
+                write(data, size);
+            }
+
+            entries.push_back(entry);
+        }
+
+        void ZipWriter::finish()
+        {
+            auto directoryOffset = offset;
+            for (size_t i = 0; i < entries.size(); i++)
+            {
+                const auto &entry = entries[i];
+                std::string header;
+                appendLE(header, centralHeaderSignature, 4);
+                appendLE(header, 20, 2);
+                appendLE(header, 20, 2);
+                appendLE(header, 0, 2);
+                appendLE(header, entry.method, 2);
+                appendLE(header, 0, 4);
+                appendLE(header, entry.crc, 4);
+                appendLE(header, entry.compressedSize, 4);
+                appendLE(header, entry.uncompressedSize, 4);
+                appendLE(header, entry.name.size(), 2);
+                appendLE(header, 0, 2);
+                appendLE(header, 0, 2);
+                appendLE(header, 0, 2);
+                appendLE(header, 0, 2);
+                appendLE(header, 0, 4);
+                appendLE(header, localOffsets[i], 4);
+                header += entry.name;
+                write(header.data(), header.size());
+            }
+
+            if (entries.size() >= 0xFFFF || offset >= 0xFFFFFFFF)
+            {
+                throw std::runtime_error("Too many arrays for .npz");
+            }
+
+            std::string end;
+            appendLE(end, endOfDirectorySignature, 4);
+            appendLE(end, 0, 2);
+            appendLE(end, 0, 2);
+            appendLE(end, entries.size(), 2);
+            appendLE(end, entries.size(), 2);
+            appendLE(end, offset - directoryOffset, 4);
+            appendLE(end, directoryOffset, 4);
+            appendLE(end, 0, 2);
+            write(end.data(), end.size());
+
+            if (!stream.flush())
+            {
+                throw std::runtime_error("Could not write " + path);
+            }
+        }
+    }
+}
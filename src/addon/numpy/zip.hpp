@@ -0,0 +1,50 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace nodeml_torch
+{
+    namespace numpy
+    {
+        struct ZipEntry
+        {
+            std::string name;
+            // 0 stored, 8 deflate
+            uint16_t method = 0;
+            uint32_t crc = 0;
+            uint64_t compressedSize = 0;
+            uint64_t uncompressedSize = 0;
+            // Absolute offset of the entry's data, past its local header
+            uint64_t dataOffset = 0;
+        };
+
+        // Reads the central directory, zip64 archives included
+        std::vector<ZipEntry> readZipDirectory(const uint8_t *data, size_t size);
+
+        // Inflates a raw deflate stream into exactly outSize bytes
+        void inflateRaw(const uint8_t *in, size_t inSize, uint8_t *out, size_t outSize);
+
+        // Writes entries one after the other, the central directory is written by finish
+        class ZipWriter
+        {
+        public:
+            ZipWriter(const std::string &path);
+
+            // The entry's content is prefix followed by data
+            void add(const std::string &name, const std::string &prefix, const uint8_t *data, size_t size, bool compress);
+
+            void finish();
+
+        private:
+            std::string path;
+            std::ofstream stream;
+            std::vector<ZipEntry> entries;
+            std::vector<uint64_t> localOffsets;
+            uint64_t offset = 0;
+
+            void write(const void *data, size_t size);
+        };
+    }
+}
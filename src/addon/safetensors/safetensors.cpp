@@ -0,0 +1,739 @@
+#include <addon/safetensors/safetensors.hpp>
+#include <addon/FunctionWorker.hpp>
+#include <addon/MappedFile.hpp>
+#include <addon/Tensor.hpp>
+#include <c10/util/safe_numerics.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace nodeml_torch
+{
+    namespace safetensors
+    {
+        // Refuse headers that could only come from a corrupt file before allocating for them
+        static const uint64_t maxHeaderBytes = 100000000;
+
+        static torch::ScalarType dtypeFromString(const std::string &dtype)
+        {
+            static const std::vector<std::pair<std::string, torch::ScalarType>> dtypes = {
+                {"F64", torch::kDouble}, {"F32", torch::kFloat}, {"F16", torch::kHalf}, {"BF16", torch::kBFloat16}, {"I64", torch::kLong}, {"I32", torch::kInt}, {"I16", torch::kShort}, {"I8", torch::kChar}, {"U8", torch::kByte}, {"BOOL", torch::kBool}};
+
+            for (const auto &[name, type] : dtypes)
+            {
+                if (name == dtype)
+                {
+                    return type;
+                }
+            }
+
+            throw std::invalid_argument("Unsupported safetensors dtype " + dtype);
+        }
+
+        static std::string dtypeToString(torch::ScalarType dtype)
+        {
+            switch (dtype)
+            {
+            case torch::kDouble:
+                return "F64";
+            case torch::kFloat:
+                return "F32";
+            case torch::kHalf:
+                return "F16";
+            case torch::kBFloat16:
+                return "BF16";
+            case torch::kLong:
+                return "I64";
+            case torch::kInt:
+                return "I32";
+            case torch::kShort:
+                return "I16";
+            case torch::kChar:
+                return "I8";
+            case torch::kByte:
+                return "U8";
+            case torch::kBool:
+                return "BOOL";
+            default:
+                throw std::invalid_argument(std::string("safetensors can not store ") + c10::toString(dtype));
+            }
+        }
+
+        // Just enough JSON for the header: objects, arrays, strings and unsigned integers are read, anything else is skipped
+        class HeaderParser
+        {
+        public:
+            HeaderParser(const std::string &text) : text(text) {}
+
+            std::vector<TensorEntry> parse()
+            {
+                std::vector<TensorEntry> entries;
+
+                expect('{');
+                if (!consume('}'))
+                {
+                    do
+                    {
+                        auto name = parseString();
+                        expect(':');
+                        if (name == "__metadata__")
+                        {
+                            skipValue();
+                        }
+                        else
+                        {
+                            entries.push_back(parseEntry(name));
+                        }
+                    } while (consume(','));
+                    expect('}');
+                }
+
+                return entries;
+            }
+
+        private:
+            const std::string &text;
+            size_t pos = 0;
+
+            [[noreturn]] void fail(const std::string &what)
+            {
+                throw std::runtime_error("Invalid safetensors header at " + std::to_string(pos) + ": " + what);
+            }
+
+            void skipWhitespace()
+            {
+                while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos])))
+                {
+                    pos++;
+                }
+            }
+
+            char peek()
+            {
+                skipWhitespace();
+                if (pos >= text.size())
+                {
+                    fail("unexpected end");
+                }
+                return text[pos];
+            }
+
+            bool consume(char c)
+            {
+                if (peek() == c)
+                {
+                    pos++;
+                    return true;
+                }
+                return false;
+            }
+
+            void expect(char c)
+            {
+                if (!consume(c))
+                {
+                    fail(std::string("expected '") + c + "'");
+                }
+            }
+
+            static void appendUtf8(std::string &out, uint32_t code)
+            {
+                if (code < 0x80)
+                {
+                    out += char(code);
+                }
+                else if (code < 0x800)
+                {
+                    out += char(0xC0 | (code >> 6));
+                    out += char(0x80 | (code & 0x3F));
+                }
+                else if (code < 0x10000)
+                {
+                    out += char(0xE0 | (code >> 12));
+                    out += char(0x80 | ((code >> 6) & 0x3F));
+                    out += char(0x80 | (code & 0x3F));
+                }
+                else
+                {
+                    out += char(0xF0 | (code >> 18));
+                    out += char(0x80 | ((code >> 12) & 0x3F));
+                    out += char(0x80 | ((code >> 6) & 0x3F));
+                    out += char(0x80 | (code & 0x3F));
+                }
+            }
+
+            uint32_t parseHex4()
+            {
+                if (pos + 4 > text.size())
+                {
+                    fail("truncated escape");
+                }
+                uint32_t code = 0;
+                for (int i = 0; i < 4; i++)
+                {
+                    auto c = text[pos++];
+                    code <<= 4;
+                    if (c >= '0' && c <= '9')
+                        code |= c - '0';
+                    else if (c >= 'a' && c <= 'f')
+                        code |= c - 'a' + 10;
+                    else if (c >= 'A' && c <= 'F')
+                        code |= c - 'A' + 10;
+                    else
+                        fail("invalid escape");
+                }
+                return code;
+            }
+
+            std::string parseString()
+            {
+                expect('"');
+                std::string out;
+                while (true)
+                {
+                    if (pos >= text.size())
+                    {
+                        fail("unterminated string");
+                    }
+                    auto c = text[pos++];
+                    if (c == '"')
+                    {
+                        return out;
+                    }
+                    if (c != '\\')
+                    {
+                        out += c;
+                        continue;
+                    }
+                    if (pos >= text.size())
+                    {
+                        fail("unterminated string");
+                    }
+                    switch (text[pos++])
+                    {
+                    case '"':
+                        out += '"';
+                        break;
+                    case '\\':
+                        out += '\\';
+                        break;
+                    case '/':
+                        out += '/';
+                        break;
+                    case 'b':
+                        out += '\b';
+                        break;
+                    case 'f':
+                        out += '\f';
+                        break;
+                    case 'n':
+                        out += '\n';
+                        break;
+                    case 'r':
+                        out += '\r';
+                        break;
+                    case 't':
+                        out += '\t';
+                        break;
+                    case 'u':
+                    {
+                        auto code = parseHex4();
+                        if (code >= 0xD800 && code < 0xDC00 && pos + 1 < text.size() && text[pos] == '\\' && text[pos + 1] == 'u')
+                        {
+                            pos += 2;
+                            auto low = parseHex4();
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        appendUtf8(out, code);
+                        break;
+                    }
+                    default:
+                        fail("invalid escape");
+                    }
+                }
+            }
+
+            uint64_t parseUnsigned()
+            {
+                skipWhitespace();
+                auto start = pos;
+                uint64_t value = 0;
+                while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])))
+                {
+                    value = value * 10 + uint64_t(text[pos++] - '0');
+                }
+                if (pos == start)
+                {
+                    fail("expected an unsigned integer");
+                }
+                return value;
+            }
+
+            std::vector<uint64_t> parseUnsignedArray()
+            {
+                std::vector<uint64_t> values;
+                expect('[');
+                if (!consume(']'))
+                {
+                    do
+                    {
+                        values.push_back(parseUnsigned());
+                    } while (consume(','));
+                    expect(']');
+                }
+                return values;
+            }
+
+            void skipValue()
+            {
+                auto c = peek();
+                if (c == '"')
+                {
+                    parseString();
+                }
+                else if (c == '{' || c == '[')
+                {
+                    auto close = c == '{' ? '}' : ']';
+                    pos++;
+                    if (consume(close))
+                    {
+                        return;
+                    }
+                    do
+                    {
+                        if (c == '{')
+                        {
+                            parseString();
+                            expect(':');
+                        }
+                        skipValue();
+                    } while (consume(','));
+                    expect(close);
+                }
+                else
+                {
+                    while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']')
+                    {
+                        pos++;
+                    }
+                }
+            }
+
+            TensorEntry parseEntry(const std::string &name)
+            {
+                TensorEntry entry;
+                entry.name = name;
+                bool hasDtype = false, hasShape = false, hasOffsets = false;
+
+                expect('{');
+                if (!consume('}'))
+                {
+                    do
+                    {
+                        auto key = parseString();
+                        expect(':');
+                        if (key == "dtype")
+                        {
+                            entry.dtype = dtypeFromString(parseString());
+                            hasDtype = true;
+                        }
+                        else if (key == "shape")
+                        {
+                            for (auto dim : parseUnsignedArray())
+                            {
+                                entry.shape.push_back(int64_t(dim));
+                            }
+                            hasShape = true;
+                        }
+                        else if (key == "data_offsets")
+                        {
+                            auto offsets = parseUnsignedArray();
+                            if (offsets.size() != 2 || offsets[1] < offsets[0])
+                            {
+                                fail("invalid data_offsets for " + name);
+                            }
+                            entry.begin = offsets[0];
+                            entry.end = offsets[1];
+                            hasOffsets = true;
+                        }
+                        else
+                        {
+                            skipValue();
+                        }
+                    } while (consume(','));
+                    expect('}');
+                }
+
+                if (!hasDtype || !hasShape || !hasOffsets)
+                {
+                    fail("incomplete entry for " + name);
+                }
+
+                return entry;
+            }
+        };
+
+        std::vector<TensorEntry> parseHeader(const std::string &header)
+        {
+            return HeaderParser(header).parse();
+        }
+
+        static std::string jsonString(const std::string &value)
+        {
+            std::string out = "\"";
+            for (auto c : value)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    out += '\\';
+                    out += c;
+                }
+                else if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[7];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+            return out + "\"";
+        }
+
+        static uint64_t readLittleEndian64(const uint8_t *bytes)
+        {
+            uint64_t value = 0;
+            for (int i = 7; i >= 0; i--)
+            {
+                value = (value << 8) | bytes[i];
+            }
+            return value;
+        }
+
+        // Keeps the requested entries in the order they were asked for, all of them when names is empty
+        static std::vector<TensorEntry> selectEntries(const std::vector<TensorEntry> &entries, const std::vector<std::string> &names, uint64_t dataBytes)
+        {
+            for (const auto &entry : entries)
+            {
+                // Huge dims must not wrap around to a product that happens to match the offsets
+                uint64_t numel = 0;
+                uint64_t expected = 0;
+                auto invalid = std::any_of(entry.shape.begin(), entry.shape.end(), [](int64_t dim)
+                                           { return dim < 0; }) ||
+                               c10::safe_multiplies_u64(entry.shape, &numel) ||
+                               c10::mul_overflows(numel, uint64_t(c10::elementSize(entry.dtype)), &expected);
+
+                if (invalid || entry.begin > entry.end || entry.end > dataBytes || entry.end - entry.begin != expected)
+                {
+                    throw std::runtime_error("safetensors entry " + entry.name + " does not match its data_offsets");
+                }
+            }
+
+            if (names.empty())
+            {
+                return entries;
+            }
+
+            std::vector<TensorEntry> selected;
+            for (const auto &name : names)
+            {
+                auto found = std::find_if(entries.begin(), entries.end(), [&](const TensorEntry &entry)
+                                          { return entry.name == name; });
+                if (found == entries.end())
+                {
+                    throw std::invalid_argument("safetensors file has no tensor " + name);
+                }
+                selected.push_back(*found);
+            }
+            return selected;
+        }
+
+        std::vector<std::pair<std::string, torch::Tensor>> loadFile(const std::string &path, bool mmap, const std::vector<std::string> &names)
+        {
+            std::vector<std::pair<std::string, torch::Tensor>> tensors;
+
+            if (mmap)
+            {
+                auto file = MappedFile::Open(path);
+                if (file->size() < 8)
+                {
+                    throw std::runtime_error(path + " is not a safetensors file");
+                }
+
+                auto headerBytes = readLittleEndian64(file->data());
+                if (headerBytes > maxHeaderBytes || 8 + headerBytes > file->size())
+                {
+                    throw std::runtime_error(path + " has an invalid safetensors header length");
+                }
+
+                auto header = std::string(reinterpret_cast<const char *>(file->data() + 8), headerBytes);
+                auto dataStart = file->data() + 8 + headerBytes;
+                auto entries = selectEntries(parseHeader(header), names, file->size() - 8 - headerBytes);
+
+                for (const auto &entry : entries)
+                {
+                    auto data = dataStart + entry.begin;
+                    auto tensor = torch::from_blob(
+                        data, entry.shape, [file](void *) {}, torch::TensorOptions(entry.dtype));
+
+                    // Kernels assume element aligned data, files written by other tools do not always guarantee it
+                    if (reinterpret_cast<uintptr_t>(data) % c10::elementSize(entry.dtype) != 0)
+                    {
+                        tensor = tensor.clone();
+                    }
+                    tensors.emplace_back(entry.name, tensor);
+                }
+
+                return tensors;
+            }
+
+            std::ifstream stream(path, std::ios::binary | std::ios::ate);
+            if (!stream)
+            {
+                throw std::runtime_error("Could not open " + path);
+            }
+
+            auto fileBytes = uint64_t(stream.tellg());
+            stream.seekg(0);
+
+            uint8_t lengthBytes[8];
+            if (fileBytes < 8 || !stream.read(reinterpret_cast<char *>(lengthBytes), 8))
+            {
+                throw std::runtime_error(path + " is not a safetensors file");
+            }
+
+            auto headerBytes = readLittleEndian64(lengthBytes);
+            if (headerBytes > maxHeaderBytes || 8 + headerBytes > fileBytes)
+            {
+                throw std::runtime_error(path + " has an invalid safetensors header length");
+            }
+
+            std::string header(headerBytes, '\0');
+            stream.read(&header[0], std::streamsize(headerBytes));
+            auto entries = selectEntries(parseHeader(header), names, fileBytes - 8 - headerBytes);
+
+            for (const auto &entry : entries)
+            {
+                auto tensor = torch::empty(entry.shape, torch::TensorOptions(entry.dtype));
+                stream.seekg(std::streamoff(8 + headerBytes + entry.begin));
+                if (!stream.read(static_cast<char *>(tensor.data_ptr()), std::streamsize(entry.end - entry.begin)))
+                {
+                    throw std::runtime_error("Could not read " + entry.name + " from " + path);
+                }
+                tensors.emplace_back(entry.name, tensor);
+            }
+
+            return tensors;
+        }
+
+        void saveFile(const std::string &path, const std::vector<std::pair<std::string, torch::Tensor>> &tensors,
+                      const std::vector<std::pair<std::string, std::string>> &metadata)
+        {
+            std::vector<std::pair<std::string, torch::Tensor>> ordered;
+            for (const auto &[name, tensor] : tensors)
+            {
+                dtypeToString(tensor.scalar_type());
+                ordered.emplace_back(name, tensor.cpu().contiguous());
+            }
+
+            std::stable_sort(ordered.begin(), ordered.end(), [](const auto &a, const auto &b)
+                             { return a.second.element_size() > b.second.element_size(); });
+
+            std::ostringstream header;
+            header << "{";
+            bool first = true;
+
+            if (!metadata.empty())
+            {
+                header << "\"__metadata__\":{";
+                for (size_t i = 0; i < metadata.size(); i++)
+                {
+                    header << (i > 0 ? "," : "") << jsonString(metadata[i].first) << ":" << jsonString(metadata[i].second);
+                }
+                header << "}";
+                first = false;
+            }
+
+            uint64_t offset = 0;
+            for (const auto &[name, tensor] : ordered)
+            {
+                auto bytes = uint64_t(tensor.nbytes());
+                header << (first ? "" : ",") << jsonString(name) << ":{\"dtype\":\"" << dtypeToString(tensor.scalar_type()) << "\",\"shape\":[";
+                for (int64_t i = 0; i < tensor.dim(); i++)
+                {
+                    header << (i > 0 ? "," : "") << tensor.size(i);
+                }
+                header << "],\"data_offsets\":[" << offset << "," << offset + bytes << "]}";
+                offset += bytes;
+                first = false;
+            }
+            header << "}";
+
+            // Padding the header keeps the data section 8 byte aligned
+            auto headerText = header.str();
+            headerText.append((8 - headerText.size() % 8) % 8, ' ');
+
+            std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+            if (!stream)
+            {
+                throw std::runtime_error("Could not open " + path + " for writing");
+            }
+
+            uint8_t lengthBytes[8];
+            uint64_t headerBytes = headerText.size();
+            for (int i = 0; i < 8; i++)
+            {
+                lengthBytes[i] = uint8_t(headerBytes >> (8 * i));
+            }
+
+            stream.write(reinterpret_cast<const char *>(lengthBytes), 8);
+            stream.write(headerText.data(), std::streamsize(headerText.size()));
+            for (const auto &[name, tensor] : ordered)
+            {
+                stream.write(static_cast<const char *>(tensor.data_ptr()), std::streamsize(tensor.nbytes()));
+            }
+
+            if (!stream.flush())
+            {
+                throw std::runtime_error("Could not write " + path);
+            }
+        }
+
+        Napi::Value load(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                if (!info[0].IsString())
+                {
+                    throw Napi::Error::New(env, "Path Must Be A String");
+                }
+
+                auto path = info[0].ToString().Utf8Value();
+                bool mmap = true;
+                std::vector<std::string> names;
+
+                if (info.Length() > 1 && info[1].IsObject())
+                {
+                    auto options = info[1].ToObject();
+                    if (options.Has("mmap"))
+                    {
+                        mmap = options.Get("mmap").ToBoolean().Value();
+                    }
+                    if (options.Has("names"))
+                    {
+                        auto array = options.Get("names").As<Napi::Array>();
+                        for (uint32_t i = 0; i < array.Length(); i++)
+                        {
+                            names.push_back(array.Get(i).ToString().Utf8Value());
+                        }
+                    }
+                }
+
+                auto worker = new FunctionWorker<std::vector<std::pair<std::string, torch::Tensor>>>(
+                    env,
+                    [=]() -> std::vector<std::pair<std::string, torch::Tensor>>
+                    {
+                        return loadFile(path, mmap, names);
+                    },
+                    [=](Napi::Env env, std::vector<std::pair<std::string, torch::Tensor>> tensors) -> Napi::Value
+                    {
+                        auto result = Napi::Object::New(env);
+                        for (const auto &[name, tensor] : tensors)
+                        {
+                            result.Set(name, Tensor::FromTorchTensor(env, tensor));
+                        }
+                        return result;
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value save(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                if (!info[0].IsString())
+                {
+                    throw Napi::Error::New(env, "Path Must Be A String");
+                }
+
+                if (!info[1].IsObject())
+                {
+                    throw Napi::Error::New(env, "Tensors Must Be An Object");
+                }
+
+                auto path = info[0].ToString().Utf8Value();
+                std::vector<std::pair<std::string, torch::Tensor>> tensors;
+                std::vector<std::pair<std::string, std::string>> metadata;
+
+                auto tensorsObject = info[1].ToObject();
+                auto keys = tensorsObject.GetPropertyNames();
+                for (uint32_t i = 0; i < keys.Length(); i++)
+                {
+                    auto name = keys.Get(i).ToString().Utf8Value();
+                    auto value = tensorsObject.Get(name);
+                    if (!value.IsObject() || !Tensor::IsInstance(value.ToObject()))
+                    {
+                        throw Napi::Error::New(env, name + " Is Not A Tensor");
+                    }
+                    tensors.emplace_back(name, Tensor::FromObject(value)->torchTensor);
+                }
+
+                if (info.Length() > 2 && info[2].IsObject() && info[2].ToObject().Has("metadata"))
+                {
+                    auto metadataObject = info[2].ToObject().Get("metadata").ToObject();
+                    auto metadataKeys = metadataObject.GetPropertyNames();
+                    for (uint32_t i = 0; i < metadataKeys.Length(); i++)
+                    {
+                        auto key = metadataKeys.Get(i).ToString().Utf8Value();
+                        metadata.emplace_back(key, metadataObject.Get(key).ToString().Utf8Value());
+                    }
+                }
+
+                auto worker = new FunctionWorker<bool>(
+                    env,
+                    [=]() -> bool
+                    {
+                        saveFile(path, tensors, metadata);
+                        return true;
+                    },
+                    [=](Napi::Env env, bool) -> Napi::Value
+                    {
+                        return env.Undefined();
+                    });
+
+                worker->Queue();
+                return worker->GetPromise();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Object Init(Napi::Env env, Napi::Object exports)
+        {
+            auto myExports = Napi::Object::New(env);
+
+            myExports.Set("load", Napi::Function::New(env, load));
+            myExports.Set("save", Napi::Function::New(env, save));
+
+            exports.Set("safetensors", myExports);
+
+            return exports;
+        }
+    }
+}
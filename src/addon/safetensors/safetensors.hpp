@@ -0,0 +1,38 @@
+#pragma once
+
+#include <napi.h>
+
+#include <string>
+#include <torch/torch.h>
+#include <vector>
+
+namespace nodeml_torch
+{
+    namespace safetensors
+    {
+        struct TensorEntry
+        {
+            std::string name;
+            torch::ScalarType dtype = torch::kFloat;
+            std::vector<int64_t> shape;
+            uint64_t begin = 0;
+            uint64_t end = 0;
+        };
+
+        // Parses the JSON header, __metadata__ is skipped
+        std::vector<TensorEntry> parseHeader(const std::string &header);
+
+        // Memory mapped tensors share the file's pages and are only copied when misaligned
+        std::vector<std::pair<std::string, torch::Tensor>> loadFile(const std::string &path, bool mmap, const std::vector<std::string> &names);
+
+        // Tensors are ordered by element size so every data offset is aligned to its dtype
+        void saveFile(const std::string &path, const std::vector<std::pair<std::string, torch::Tensor>> &tensors,
+                      const std::vector<std::pair<std::string, std::string>> &metadata);
+
+        Napi::Value load(const Napi::CallbackInfo &info);
+
+        Napi::Value save(const Napi::CallbackInfo &info);
+
+        Napi::Object Init(Napi::Env env, Napi::Object exports);
+    }
+}
@@ -0,0 +1,65 @@
+#include <addon/sampling.hpp>
+
+#include <ATen/CPUGeneratorImpl.h>
+#include <limits>
+
+namespace nodeml_torch
+{
+    namespace sampling
+    {
+        static const double negativeInfinity = -std::numeric_limits<double>::infinity();
+
+        at::Generator makeGenerator(uint64_t seed)
+        {
+            return at::make_generator<at::CPUGeneratorImpl>(seed);
+        }
+
+        torch::Tensor maskTopK(const torch::Tensor &logits, int64_t k)
+        {
+            if (k <= 0 || k >= logits.size(-1))
+            {
+                return logits;
+            }
+
+            auto kth = std::get<0>(logits.topk(k, -1)).narrow(-1, k - 1, 1);
+            return logits.masked_fill(logits < kth, negativeInfinity);
+        }
+
+        torch::Tensor maskTopP(const torch::Tensor &logits, double p)
+        {
+            if (p >= 1.0)
+            {
+                return logits;
+            }
+
+            auto [sorted, indices] = logits.sort(-1, true);
+            auto probs = sorted.softmax(-1);
+
+            // Mass before each token, so the token that crosses p is still kept
+            auto remove = (probs.cumsum(-1) - probs) > p;
+            return logits.scatter(-1, indices, sorted.masked_fill(remove, negativeInfinity));
+        }
+
+        torch::Tensor sample(const torch::Tensor &logits, const SamplingOptions &options, c10::optional<at::Generator> generator)
+        {
+            if (options.temperature <= 0.0)
+            {
+                return logits.argmax(-1);
+            }
+
+            auto scores = logits.to(torch::kFloat32) / options.temperature;
+            scores = maskTopK(scores, options.topK);
+            scores = maskTopP(scores, options.topP);
+
+            auto probs = scores.softmax(-1);
+            if (generator.has_value() && !probs.is_cpu())
+            {
+                probs = probs.cpu();
+            }
+
+            auto flat = probs.reshape({-1, probs.size(-1)});
+            auto tokens = flat.multinomial(1, false, generator).view(logits.sizes().slice(0, logits.dim() - 1));
+            return tokens.to(logits.device());
+        }
+    }
+}
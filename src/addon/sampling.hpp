@@ -0,0 +1,28 @@
+#pragma once
+
+#include <torch/torch.h>
+
+namespace nodeml_torch
+{
+    namespace sampling
+    {
+        struct SamplingOptions
+        {
+            // 0 picks the most likely token
+            double temperature = 0.0;
+            int64_t topK = 0;
+            double topP = 1.0;
+        };
+
+        at::Generator makeGenerator(uint64_t seed);
+
+        // Sets every logit outside the k largest along the last dim to -inf
+        torch::Tensor maskTopK(const torch::Tensor &logits, int64_t k);
+
+        // Sets every logit outside the smallest set whose probability reaches p to -inf, always keeping the best one
+        torch::Tensor maskTopP(const torch::Tensor &logits, double p);
+
+        // logits [..., vocab] -> token ids [...]
+        torch::Tensor sample(const torch::Tensor &logits, const SamplingOptions &options, c10::optional<at::Generator> generator);
+    }
+}
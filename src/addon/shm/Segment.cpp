@@ -0,0 +1,296 @@
+#include <addon/shm/Segment.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nodeml_torch
+{
+    namespace shm
+    {
+        // "NMLTSHM2" read as little endian
+        static const uint64_t segmentMagic = 0x324d4853544c4d4eULL;
+        static const uint64_t dataAlignment = 64;
+
+        struct SegmentHeader
+        {
+            uint64_t magic;
+            std::atomic<uint32_t> ready;
+            uint32_t count;
+            uint64_t totalBytes;
+            // Lets openers tell a slow creator from one that died before markReady
+            int64_t creatorPid;
+        };
+
+        static uint64_t alignUp(uint64_t value)
+        {
+            return (value + dataAlignment - 1) / dataAlignment * dataAlignment;
+        }
+
+        static std::string posixName(const std::string &name)
+        {
+            return name.size() > 0 && name[0] == '/' ? name : "/" + name;
+        }
+
+#ifdef _WIN32
+        static std::runtime_error unsupported()
+        {
+            return std::runtime_error("Shared memory tensors are only supported on POSIX systems");
+        }
+
+        Segment::Segment(void *base, size_t size) : base(base), size(size) {}
+
+        Segment::~Segment() {}
+
+        std::shared_ptr<Segment> Segment::Create(const std::string &, const std::vector<std::pair<std::vector<int64_t>, torch::ScalarType>> &)
+        {
+            throw unsupported();
+        }
+
+        std::shared_ptr<Segment> Segment::Open(const std::string &, bool, int64_t)
+        {
+            throw unsupported();
+        }
+
+        void Segment::Unlink(const std::string &)
+        {
+            throw unsupported();
+        }
+
+        void Segment::unlinkIfCurrent()
+        {
+            throw unsupported();
+        }
+#else
+        static std::runtime_error systemError(const std::string &what, const std::string &name)
+        {
+            return std::runtime_error(what + " " + name + ": " + std::strerror(errno));
+        }
+
+        // Processes in another pid namespace look dead too, sharing weights across containers is not supported
+        static bool creatorDied(int64_t pid)
+        {
+            return pid > 0 && kill(pid_t(pid), 0) != 0 && errno == ESRCH;
+        }
+
+        // Only removes the name if it still refers to the segment that was opened, a sibling may already have replaced it
+        static void unlinkIfSame(const std::string &path, uint64_t device, uint64_t inode)
+        {
+            auto fd = shm_open(path.c_str(), O_RDONLY, 0);
+            if (fd < 0)
+            {
+                return;
+            }
+
+            struct stat current;
+            auto same = fstat(fd, &current) == 0 && uint64_t(current.st_ino) == inode && uint64_t(current.st_dev) == device;
+            close(fd);
+
+            if (same)
+            {
+                shm_unlink(path.c_str());
+            }
+        }
+
+        Segment::Segment(void *base, size_t size) : base(base), size(size) {}
+
+        Segment::~Segment()
+        {
+            if (base != nullptr)
+            {
+                munmap(base, size);
+            }
+        }
+
+        std::shared_ptr<Segment> Segment::Create(const std::string &name, const std::vector<std::pair<std::vector<int64_t>, torch::ScalarType>> &tensors)
+        {
+            std::vector<SegmentEntry> entries(tensors.size());
+            uint64_t offset = alignUp(sizeof(SegmentHeader) + sizeof(SegmentEntry) * entries.size());
+
+            for (size_t i = 0; i < tensors.size(); i++)
+            {
+                auto &[shape, dtype] = tensors[i];
+                if (int64_t(shape.size()) > maxSegmentDims)
+                {
+                    throw std::invalid_argument("Shared memory tensors support at most 8 dimensions");
+                }
+
+                auto &entry = entries[i];
+                std::memset(&entry, 0, sizeof(entry));
+                entry.offset = offset;
+                entry.bytes = c10::multiply_integers(shape) * c10::elementSize(dtype);
+                entry.dtype = int32_t(dtype);
+                entry.ndim = int32_t(shape.size());
+                std::copy(shape.begin(), shape.end(), entry.shape);
+                offset = alignUp(offset + entry.bytes);
+            }
+
+            auto path = posixName(name);
+            auto fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+            if (fd < 0 && errno == EEXIST)
+            {
+                return nullptr;
+            }
+            if (fd < 0)
+            {
+                throw systemError("Could not create shared memory", path);
+            }
+
+            if (ftruncate(fd, off_t(offset)) != 0)
+            {
+                auto error = systemError("Could not size shared memory", path);
+                close(fd);
+                shm_unlink(path.c_str());
+                throw error;
+            }
+
+            auto base = mmap(nullptr, offset, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (base == MAP_FAILED)
+            {
+                auto error = systemError("Could not map shared memory", path);
+                shm_unlink(path.c_str());
+                throw error;
+            }
+
+            // Fresh segments are zero filled, so ready starts out false for anyone opening early
+            auto header = new (base) SegmentHeader();
+            header->count = uint32_t(entries.size());
+            header->totalBytes = offset;
+            header->creatorPid = int64_t(getpid());
+            std::memcpy(static_cast<uint8_t *>(base) + sizeof(SegmentHeader), entries.data(), sizeof(SegmentEntry) * entries.size());
+            header->magic = segmentMagic;
+
+            return std::shared_ptr<Segment>(new Segment(base, offset));
+        }
+
+        std::shared_ptr<Segment> Segment::Open(const std::string &name, bool readOnly, int64_t timeoutMs)
+        {
+            auto path = posixName(name);
+            auto fd = shm_open(path.c_str(), readOnly ? O_RDONLY : O_RDWR, 0);
+            if (fd < 0)
+            {
+                throw systemError("Could not open shared memory", path);
+            }
+
+            // The creator may not have sized the segment yet
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+            struct stat info;
+            while (true)
+            {
+                if (fstat(fd, &info) != 0)
+                {
+                    auto error = systemError("Could not stat shared memory", path);
+                    close(fd);
+                    throw error;
+                }
+                if (size_t(info.st_size) >= sizeof(SegmentHeader))
+                {
+                    break;
+                }
+
+                if (std::chrono::steady_clock::now() > deadline)
+                {
+                    close(fd);
+                    throw std::runtime_error("Timed out waiting for shared memory " + path);
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+
+            auto size = size_t(info.st_size);
+            auto base = mmap(nullptr, size, readOnly ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (base == MAP_FAILED)
+            {
+                throw systemError("Could not map shared memory", path);
+            }
+
+            auto segment = std::shared_ptr<Segment>(new Segment(base, size));
+            segment->path = path;
+            segment->device = uint64_t(info.st_dev);
+            segment->inode = uint64_t(info.st_ino);
+            auto header = static_cast<SegmentHeader *>(base);
+
+            while (header->ready.load(std::memory_order_acquire) == 0)
+            {
+                if (creatorDied(header->creatorPid))
+                {
+                    segment->unlinkIfCurrent();
+                    return nullptr;
+                }
+
+                if (std::chrono::steady_clock::now() > deadline)
+                {
+                    throw std::runtime_error("Timed out waiting for shared memory " + path + " to be filled");
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+
+            if (header->magic != segmentMagic || header->totalBytes > size)
+            {
+                throw std::runtime_error(path + " is not a nodeml_torch shared memory segment");
+            }
+
+            return segment;
+        }
+
+        void Segment::Unlink(const std::string &name)
+        {
+            auto path = posixName(name);
+            if (shm_unlink(path.c_str()) != 0 && errno != ENOENT)
+            {
+                throw systemError("Could not unlink shared memory", path);
+            }
+        }
+
+        void Segment::unlinkIfCurrent()
+        {
+            if (!path.empty())
+            {
+                unlinkIfSame(path, device, inode);
+            }
+        }
+#endif
+
+        size_t Segment::count() const
+        {
+            return static_cast<SegmentHeader *>(base)->count;
+        }
+
+        const SegmentEntry &Segment::entry(size_t index) const
+        {
+            if (index >= count())
+            {
+                throw std::out_of_range("Shared memory segment has no tensor " + std::to_string(index));
+            }
+
+            return reinterpret_cast<const SegmentEntry *>(static_cast<uint8_t *>(base) + sizeof(SegmentHeader))[index];
+        }
+
+        torch::Tensor Segment::tensor(size_t index)
+        {
+            auto &slot = entry(index);
+            std::vector<int64_t> shape(slot.shape, slot.shape + slot.ndim);
+            auto owner = shared_from_this();
+
+            return torch::from_blob(
+                static_cast<uint8_t *>(base) + slot.offset, shape, [owner](void *) {},
+                torch::TensorOptions(torch::ScalarType(slot.dtype)));
+        }
+
+        void Segment::markReady()
+        {
+            static_cast<SegmentHeader *>(base)->ready.store(1, std::memory_order_release);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <torch/torch.h>
+#include <vector>
+
+namespace nodeml_torch
+{
+    namespace shm
+    {
+        // One tensor slot of a segment, shapes are limited so the table has a fixed size
+        static const int64_t maxSegmentDims = 8;
+
+        struct SegmentEntry
+        {
+            uint64_t offset;
+            uint64_t bytes;
+            int32_t dtype;
+            int32_t ndim;
+            int64_t shape[maxSegmentDims];
+        };
+
+        // POSIX shared memory laid out as a header, an entry table and 64 byte aligned tensor data
+        class Segment : public std::enable_shared_from_this<Segment>
+        {
+        public:
+            ~Segment();
+
+            // Returns null when the name is already taken, the creator fills the data and then calls markReady
+            static std::shared_ptr<Segment> Create(const std::string &name, const std::vector<std::pair<std::vector<int64_t>, torch::ScalarType>> &tensors);
+
+            // Waits up to timeoutMs for the creator to call markReady. Returns null after unlinking
+            // a segment whose creator exited without marking it ready
+            static std::shared_ptr<Segment> Open(const std::string &name, bool readOnly, int64_t timeoutMs);
+
+            static void Unlink(const std::string &name);
+
+            size_t count() const;
+
+            const SegmentEntry &entry(size_t index) const;
+
+            // A view of one slot, the mapping stays alive for as long as the tensor does
+            torch::Tensor tensor(size_t index);
+
+            void markReady();
+
+            // Removes the name if it still refers to this opened segment, a sibling may already have replaced it
+            void unlinkIfCurrent();
+
+        private:
+            void *base = nullptr;
+            size_t size = 0;
+            // Identity of the shm object behind an opened segment, compared before unlinking its name
+            std::string path;
+            uint64_t device = 0;
+            uint64_t inode = 0;
+
+            Segment(void *base, size_t size);
+        };
+    }
+}
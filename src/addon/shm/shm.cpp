@@ -0,0 +1,220 @@
+#include <addon/shm/shm.hpp>
+#include <addon/shm/Segment.hpp>
+#include <addon/Tensor.hpp>
+#include <addon/utils.hpp>
+
+#include <cstring>
+
+namespace nodeml_torch
+{
+    namespace shm
+    {
+        static const int64_t defaultOpenTimeoutMs = 10000;
+
+        // Loading a large module can take a while, siblings wait for the first process to finish
+        static const int64_t weightsOpenTimeoutMs = 300000;
+
+        void shareModuleWeights(torch::jit::Module &module, const std::string &name)
+        {
+            std::vector<torch::Tensor> tensors;
+            for (const auto &item : module.named_parameters(true))
+            {
+                tensors.push_back(item.value);
+            }
+            for (const auto &item : module.named_buffers(true))
+            {
+                tensors.push_back(item.value);
+            }
+
+            std::vector<std::pair<std::vector<int64_t>, torch::ScalarType>> specs;
+            for (const auto &tensor : tensors)
+            {
+                if (!tensor.device().is_cpu())
+                {
+                    throw std::invalid_argument("sharedWeights requires a module with all weights on the CPU");
+                }
+                specs.emplace_back(tensor.sizes().vec(), tensor.scalar_type());
+            }
+
+            torch::NoGradGuard noGrad;
+
+            // A creator that died before markReady leaves a stale segment, which Open removes so the next round can create it.
+            // Segments are never unlinked on exit, so one left over from a previous deploy of the same architecture is
+            // compared byte for byte against the freshly loaded weights and replaced when they differ
+            for (int attempt = 0; attempt < 3; attempt++)
+            {
+                auto segment = Segment::Create(name, specs);
+                if (segment)
+                {
+                    try
+                    {
+                        for (size_t i = 0; i < tensors.size(); i++)
+                        {
+                            auto view = segment->tensor(i);
+                            view.copy_(tensors[i]);
+                            tensors[i].set_data(view);
+                        }
+                    }
+                    catch (...)
+                    {
+                        // Siblings would otherwise wait on a segment that never becomes ready
+                        Segment::Unlink(name);
+                        throw;
+                    }
+                    segment->markReady();
+                    return;
+                }
+
+                segment = Segment::Open(name, true, weightsOpenTimeoutMs);
+                if (!segment)
+                {
+                    continue;
+                }
+
+                if (segment->count() != tensors.size())
+                {
+                    throw std::runtime_error("Shared memory " + name + " holds the weights of a different module, unlink it and retry");
+                }
+
+                for (size_t i = 0; i < tensors.size(); i++)
+                {
+                    auto &entry = segment->entry(i);
+                    if (entry.dtype != int32_t(specs[i].second) || std::vector<int64_t>(entry.shape, entry.shape + entry.ndim) != specs[i].first)
+                    {
+                        throw std::runtime_error("Shared memory " + name + " holds the weights of a different module, unlink it and retry");
+                    }
+                }
+
+                auto same = true;
+                for (size_t i = 0; i < tensors.size() && same; i++)
+                {
+                    auto local = tensors[i].contiguous();
+                    auto &entry = segment->entry(i);
+                    same = local.nbytes() == entry.bytes && (entry.bytes == 0 || std::memcmp(local.data_ptr(), segment->tensor(i).data_ptr(), entry.bytes) == 0);
+                }
+
+                if (!same)
+                {
+                    // Processes still running the old weights keep their mapping, only the name is replaced
+                    segment->unlinkIfCurrent();
+                    continue;
+                }
+
+                for (size_t i = 0; i < tensors.size(); i++)
+                {
+                    tensors[i].set_data(segment->tensor(i));
+                }
+                return;
+            }
+
+            throw std::runtime_error("Shared memory " + name + " keeps being abandoned by its creator or replaced with different weights");
+        }
+
+        Napi::Value create(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                if (!info[0].IsString())
+                {
+                    throw Napi::Error::New(env, "Name Must Be A String");
+                }
+
+                auto name = info[0].ToString().Utf8Value();
+                auto shape = utils::napiArrayToVector<int64_t>(info[1].As<Napi::Array>());
+                auto dtype = info.Length() > 2 && info[2].IsString() ? utils::stringToScalarType(info[2].ToString().Utf8Value()) : torch::kFloat;
+
+                auto segment = Segment::Create(name, {{shape, dtype}});
+                if (!segment)
+                {
+                    throw Napi::Error::New(env, "Shared memory " + name + " already exists");
+                }
+
+                // Zero filled by the OS, coordinating writes is left to the caller
+                segment->markReady();
+
+                return Tensor::FromTorchTensor(env, segment->tensor(0));
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value open(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                if (!info[0].IsString())
+                {
+                    throw Napi::Error::New(env, "Name Must Be A String");
+                }
+
+                auto name = info[0].ToString().Utf8Value();
+                bool readOnly = false;
+                int64_t timeoutMs = defaultOpenTimeoutMs;
+
+                if (info.Length() > 1 && info[1].IsObject())
+                {
+                    auto options = info[1].ToObject();
+                    if (options.Has("readOnly"))
+                    {
+                        readOnly = options.Get("readOnly").ToBoolean().Value();
+                    }
+                    if (options.Has("timeout"))
+                    {
+                        timeoutMs = options.Get("timeout").ToNumber().Int64Value();
+                    }
+                }
+
+                auto segment = Segment::Open(name, readOnly, timeoutMs);
+                if (!segment)
+                {
+                    throw Napi::Error::New(env, "Shared memory " + name + " was abandoned by its creator and has been removed");
+                }
+
+                // Not copied even when read only, avoiding the copy is the point of the segment. libtorch has no
+                // read only tensors, so writes to a PROT_READ view fault; index.d.ts documents it
+                return Tensor::FromTorchTensor(env, segment->tensor(0));
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Value unlink(const Napi::CallbackInfo &info)
+        {
+            auto env = info.Env();
+            try
+            {
+                if (!info[0].IsString())
+                {
+                    throw Napi::Error::New(env, "Name Must Be A String");
+                }
+
+                Segment::Unlink(info[0].ToString().Utf8Value());
+
+                return env.Undefined();
+            }
+            catch (const std::exception &e)
+            {
+                throw Napi::Error::New(env, e.what());
+            }
+        }
+
+        Napi::Object Init(Napi::Env env, Napi::Object exports)
+        {
+            auto myExports = Napi::Object::New(env);
+
+            myExports.Set("create", Napi::Function::New(env, create));
+            myExports.Set("open", Napi::Function::New(env, open));
+            myExports.Set("unlink", Napi::Function::New(env, unlink));
+
+            exports.Set("shm", myExports);
+
+            return exports;
+        }
+    }
+}
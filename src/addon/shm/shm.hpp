@@ -0,0 +1,24 @@
+#pragma once
+
+#include <napi.h>
+
+#include <string>
+#include <torch/script.h>
+
+namespace nodeml_torch
+{
+    namespace shm
+    {
+        // Moves the parameters and buffers of a CPU module into the named segment. The first process
+        // to get there fills it, later ones map it read only and drop their private copy once it matches byte for byte
+        void shareModuleWeights(torch::jit::Module &module, const std::string &name);
+
+        Napi::Value create(const Napi::CallbackInfo &info);
+
+        Napi::Value open(const Napi::CallbackInfo &info);
+
+        Napi::Value unlink(const Napi::CallbackInfo &info);
+
+        Napi::Object Init(Napi::Env env, Napi::Object exports);
+    }
+}
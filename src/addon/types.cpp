@@ -14,6 +14,13 @@ namespace nodeml_torch
             TypeObject.Set("uint8", torchUint8Type);
             TypeObject.Set("long", torchLongType);
             TypeObject.Set("bool", torchBooleanType);
+            TypeObject.Set("float16", torchFloat16Type);
+            TypeObject.Set("bfloat16", torchBFloat16Type);
+            TypeObject.Set("int8", torchInt8Type);
+            TypeObject.Set("int16", torchInt16Type);
+            TypeObject.Set("qint8", torchQInt8Type);
+            TypeObject.Set("quint8", torchQUInt8Type);
+            TypeObject.Set("qint32", torchQInt32Type);
             exports.Set("types", TypeObject);
             return exports;
         }
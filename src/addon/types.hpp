@@ -13,6 +13,14 @@ namespace nodeml_torch
         static const std::string torchUint8Type = "uint8";
         static const std::string torchLongType = "long";
         static const std::string torchBooleanType = "bool";
+        static const std::string torchFloat16Type = "float16";
+        static const std::string torchBFloat16Type = "bfloat16";
+        static const std::string torchInt8Type = "int8";
+        static const std::string torchInt16Type = "int16";
+        // Only produced by quantized ops, tensors of these types can not be created through type()
+        static const std::string torchQInt8Type = "qint8";
+        static const std::string torchQUInt8Type = "quint8";
+        static const std::string torchQInt32Type = "qint32";
 
         Napi::Object Init(Napi::Env env, Napi::Object exports);
     }
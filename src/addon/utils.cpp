@@ -129,6 +129,19 @@ namespace nodeml_torch
             return arr;
         }
 
+        template <>
+        Napi::Array vectorToNapiArray(Napi::Env env, std::vector<int64_t> vec)
+        {
+            auto arr = Napi::Array::New(env, vec.size());
+
+            for (auto i = 0; i < vec.size(); i++)
+            {
+                arr.Set(uint32_t(i), double(vec.at(i)));
+            }
+
+            return arr;
+        }
+
         template <>
         Napi::Array vectorToNapiArray(Napi::Env env, std::vector<size_t> vec)
         {
@@ -154,6 +167,11 @@ namespace nodeml_torch
         template <>
         torch::ScalarType scalarType<uint8_t>() { return torch::kUInt8; }
 
+        template <>
+        torch::ScalarType scalarType<int8_t>() { return torch::kInt8; }
+        template <>
+        torch::ScalarType scalarType<int16_t>() { return torch::kInt16; }
+
         template <>
         torch::ScalarType scalarType<bool>() { return torch::kBool; }
 
@@ -183,10 +201,308 @@ namespace nodeml_torch
             {
                 return torch::kBool;
             }
+            else if (typeString == types::torchFloat16Type)
+            {
+                return torch::kFloat16;
+            }
+            else if (typeString == types::torchBFloat16Type)
+            {
+                return torch::kBFloat16;
+            }
+            else if (typeString == types::torchInt8Type)
+            {
+                return torch::kInt8;
+            }
+            else if (typeString == types::torchInt16Type)
+            {
+                return torch::kInt16;
+            }
 
             return torch::kFloat32;
         }
 
+        std::string scalarTypeToString(torch::ScalarType type)
+        {
+            switch (type)
+            {
+            case torch::ScalarType::Float:
+                return types::torchFloatType;
+            case torch::ScalarType::Double:
+                return types::torchDoubleType;
+            case torch::ScalarType::Int:
+                return types::torchInt32Type;
+            case torch::ScalarType::Long:
+                return types::torchLongType;
+            case torch::ScalarType::Byte:
+                return types::torchUint8Type;
+            case torch::ScalarType::Bool:
+                return types::torchBooleanType;
+            case torch::ScalarType::Half:
+                return types::torchFloat16Type;
+            case torch::ScalarType::BFloat16:
+                return types::torchBFloat16Type;
+            case torch::ScalarType::Char:
+                return types::torchInt8Type;
+            case torch::ScalarType::Short:
+                return types::torchInt16Type;
+            case torch::ScalarType::QInt8:
+                return types::torchQInt8Type;
+            case torch::ScalarType::QUInt8:
+                return types::torchQUInt8Type;
+            case torch::ScalarType::QInt32:
+                return types::torchQInt32Type;
+            default:
+                throw std::invalid_argument(std::string("Unsupported type ") + c10::toString(type));
+            }
+        }
+
+        torch::MemoryFormat stringToMemoryFormat(const std::string &format)
+        {
+            if (format == "contiguous")
+            {
+                return torch::MemoryFormat::Contiguous;
+            }
+            else if (format == "channelsLast")
+            {
+                return torch::MemoryFormat::ChannelsLast;
+            }
+            else if (format == "channelsLast3d")
+            {
+                return torch::MemoryFormat::ChannelsLast3d;
+            }
+
+            throw std::invalid_argument("Unknown memory format " + format);
+        }
+
+        std::string memoryFormatToString(torch::MemoryFormat format)
+        {
+            switch (format)
+            {
+            case torch::MemoryFormat::ChannelsLast:
+                return "channelsLast";
+            case torch::MemoryFormat::ChannelsLast3d:
+                return "channelsLast3d";
+            default:
+                return "contiguous";
+            }
+        }
+
+        template <typename T>
+        static T napiLeafValue(const Napi::Value &value)
+        {
+            switch (value.Type())
+            {
+            case napi_number:
+                return static_cast<T>(value.As<Napi::Number>().DoubleValue());
+            case napi_boolean:
+                return static_cast<T>(value.As<Napi::Boolean>().Value());
+            case napi_bigint:
+            {
+                bool lossless;
+                return static_cast<T>(value.As<Napi::BigInt>().Int64Value(&lossless));
+            }
+            case napi_object:
+                throw std::invalid_argument("Found an object where a value was expected, the nested array may be ragged");
+            default:
+                throw std::invalid_argument("Nested arrays may only hold numbers, booleans and bigints");
+            }
+        }
+
+        template <typename T>
+        static void fillFromNestedArray(Napi::Env env, const Napi::Array &arr, const std::vector<int64_t> &shape, size_t depth, T *&out)
+        {
+            auto length = arr.Length();
+            if (int64_t(length) != shape[depth])
+            {
+                throw std::invalid_argument("Nested array is ragged at depth " + std::to_string(depth) + ", expected " +
+                                            std::to_string(shape[depth]) + " elements but got " + std::to_string(length));
+            }
+
+            if (depth + 1 == shape.size())
+            {
+                Napi::HandleScope scope(env);
+                for (uint32_t i = 0; i < length; i++)
+                {
+                    *out++ = napiLeafValue<T>(arr.Get(i));
+                }
+                return;
+            }
+
+            for (uint32_t i = 0; i < length; i++)
+            {
+                Napi::HandleScope scope(env);
+                auto child = arr.Get(i);
+                if (!child.IsArray())
+                {
+                    throw std::invalid_argument("Nested array is ragged at depth " + std::to_string(depth + 1) + ", expected an array");
+                }
+                fillFromNestedArray<T>(env, child.As<Napi::Array>(), shape, depth + 1, out);
+            }
+        }
+
+        template <typename T>
+        static void fillTensorFromNested(Napi::Env env, const Napi::Value &value, const std::vector<int64_t> &shape, torch::Tensor &tensor)
+        {
+            auto *out = tensor.data_ptr<T>();
+            if (shape.empty())
+            {
+                *out = napiLeafValue<T>(value);
+                return;
+            }
+            fillFromNestedArray<T>(env, value.As<Napi::Array>(), shape, 0, out);
+        }
+
+        torch::Tensor nestedArrayToTensor(Napi::Env env, const Napi::Value &value, c10::optional<torch::ScalarType> dtype)
+        {
+            std::vector<int64_t> shape;
+            auto leaf = value;
+            while (leaf.IsArray())
+            {
+                auto arr = leaf.As<Napi::Array>();
+                shape.push_back(arr.Length());
+                if (arr.Length() == 0)
+                {
+                    break;
+                }
+                leaf = arr.Get(uint32_t(0));
+            }
+
+            auto inferred = torch::kFloat32;
+            if (leaf.IsBoolean())
+            {
+                inferred = torch::kBool;
+            }
+            else if (leaf.IsBigInt())
+            {
+                inferred = torch::kInt64;
+            }
+
+            auto target = dtype.value_or(inferred);
+
+            // Half precision has no C++ arithmetic type to write through, it is filled as float and narrowed once
+            auto isHalf = target == torch::kHalf || target == torch::kBFloat16;
+            auto tensor = torch::empty(shape, torch::TensorOptions(isHalf ? torch::kFloat32 : target));
+
+            switch (tensor.scalar_type())
+            {
+            case torch::ScalarType::Float:
+                fillTensorFromNested<float>(env, value, shape, tensor);
+                break;
+            case torch::ScalarType::Double:
+                fillTensorFromNested<double>(env, value, shape, tensor);
+                break;
+            case torch::ScalarType::Int:
+                fillTensorFromNested<int32_t>(env, value, shape, tensor);
+                break;
+            case torch::ScalarType::Long:
+                fillTensorFromNested<int64_t>(env, value, shape, tensor);
+                break;
+            case torch::ScalarType::Byte:
+                fillTensorFromNested<uint8_t>(env, value, shape, tensor);
+                break;
+            case torch::ScalarType::Char:
+                fillTensorFromNested<int8_t>(env, value, shape, tensor);
+                break;
+            case torch::ScalarType::Short:
+                fillTensorFromNested<int16_t>(env, value, shape, tensor);
+                break;
+            case torch::ScalarType::Bool:
+                fillTensorFromNested<bool>(env, value, shape, tensor);
+                break;
+            default:
+                throw std::invalid_argument(std::string("Unsupported type ") + c10::toString(target));
+            }
+
+            return isHalf ? tensor.to(target) : tensor;
+        }
+
+        template <typename T>
+        static Napi::Value napiFromElement(Napi::Env env, T value)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                return Napi::Boolean::New(env, value);
+            }
+            else
+            {
+                return Napi::Number::New(env, double(value));
+            }
+        }
+
+        // Every level is allocated at its final length, so V8 never grows a backing store
+        template <typename T>
+        static Napi::Value nestedLevelToArray(Napi::Env env, const T *&data, c10::IntArrayRef shape, size_t depth)
+        {
+            Napi::EscapableHandleScope scope(env);
+            auto length = uint32_t(shape[depth]);
+            auto arr = Napi::Array::New(env, length);
+
+            if (depth + 1 == shape.size())
+            {
+                for (uint32_t i = 0; i < length; i++)
+                {
+                    arr.Set(i, napiFromElement<T>(env, *data++));
+                }
+            }
+            else
+            {
+                for (uint32_t i = 0; i < length; i++)
+                {
+                    arr.Set(i, nestedLevelToArray<T>(env, data, shape, depth + 1));
+                }
+            }
+
+            return scope.Escape(arr);
+        }
+
+        template <typename T>
+        static Napi::Value contiguousToNested(Napi::Env env, const torch::Tensor &tensor)
+        {
+            const T *data = tensor.data_ptr<T>();
+            if (tensor.dim() == 0)
+            {
+                return napiFromElement<T>(env, *data);
+            }
+            return nestedLevelToArray<T>(env, data, tensor.sizes(), 0);
+        }
+
+        Napi::Value tensorToNestedArray(Napi::Env env, const torch::Tensor &tensor)
+        {
+            auto source = tensor.cpu();
+            if (source.is_quantized())
+            {
+                source = source.dequantize();
+            }
+            if (source.scalar_type() == torch::kHalf || source.scalar_type() == torch::kBFloat16)
+            {
+                source = source.to(torch::kFloat32);
+            }
+            source = source.contiguous();
+
+            switch (source.scalar_type())
+            {
+            case torch::ScalarType::Float:
+                return contiguousToNested<float>(env, source);
+            case torch::ScalarType::Double:
+                return contiguousToNested<double>(env, source);
+            case torch::ScalarType::Int:
+                return contiguousToNested<int32_t>(env, source);
+            // JS numbers hold integers up to 2^53 exactly, which covers the JSON use this is meant for
+            case torch::ScalarType::Long:
+                return contiguousToNested<int64_t>(env, source);
+            case torch::ScalarType::Byte:
+                return contiguousToNested<uint8_t>(env, source);
+            case torch::ScalarType::Char:
+                return contiguousToNested<int8_t>(env, source);
+            case torch::ScalarType::Short:
+                return contiguousToNested<int16_t>(env, source);
+            case torch::ScalarType::Bool:
+                return contiguousToNested<bool>(env, source);
+            default:
+                throw std::invalid_argument(std::string("Unsupported type ") + c10::toString(source.scalar_type()));
+            }
+        }
+
         bool isNapiValueInt(Napi::Env env, Napi::Value num)
         {
             return env.Global()
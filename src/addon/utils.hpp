@@ -21,9 +21,21 @@ namespace nodeml_torch
 
         torch::ScalarType stringToScalarType(std::string typeString);
 
-        template <typename T>
-        Napi::Array tensorToNestedArray(Napi::Env env, torch::Tensor &tensor,
-                                        const std::function<T(Napi::Env, Napi::Number)> &convertNumber);
+        // Inverse of stringToScalarType, throws for types without a JS name
+        std::string scalarTypeToString(torch::ScalarType type);
+
+        // 'contiguous', 'channelsLast' or 'channelsLast3d'. Preserve is left out, contiguous and is_contiguous reject it
+        torch::MemoryFormat stringToMemoryFormat(const std::string &format);
+
+        std::string memoryFormatToString(torch::MemoryFormat format);
+
+        // Walks nested JS arrays once, the shape comes from the first element at every depth.
+        // Without a dtype numbers become float, booleans bool and bigints long
+        torch::Tensor nestedArrayToTensor(Napi::Env env, const Napi::Value &value,
+                                          c10::optional<torch::ScalarType> dtype = c10::nullopt);
+
+        // Plain nested arrays of numbers (booleans for bool), quantized tensors are dequantized
+        Napi::Value tensorToNestedArray(Napi::Env env, const torch::Tensor &tensor);
 
         // https://github.com/nodejs/node-addon-api/issues/265#issuecomment-552145007
         bool isNapiValueInt(Napi::Env env, Napi::Value num);
@@ -4,14 +4,410 @@
 #include <torch/torch.h>
 #include <torchvision/vision.h>
 #include <torchvision/ops/ops.h>
+#include <torchvision/io/image/image.h>
+#include <addon/FunctionWorker.hpp>
+#include <addon/utils.hpp>
 
 namespace torchvision_ops = vision::ops;
+namespace torchvision_io = vision::image;
 namespace nodeml_torch
 {
     namespace vision
     {
         namespace ops
         {
+            std::tuple<torch::Tensor, LetterboxMeta> letterboxImage(const torch::Tensor &image, int64_t targetHeight, int64_t targetWidth,
+                                                                    double fill, int64_t stride, bool scaleUp)
+            {
+                if (image.dim() != 3 && image.dim() != 4)
+                {
+                    throw std::runtime_error("letterbox expects a CHW or NCHW tensor");
+                }
+
+                auto batched = image.dim() == 4 ? image : image.unsqueeze(0);
+
+                LetterboxMeta meta;
+                meta.height = batched.size(2);
+                meta.width = batched.size(3);
+                meta.scale = std::min(double(targetHeight) / meta.height, double(targetWidth) / meta.width);
+
+                if (!scaleUp)
+                {
+                    meta.scale = std::min(meta.scale, 1.0);
+                }
+
+                int64_t resizedHeight = std::lround(meta.height * meta.scale);
+                int64_t resizedWidth = std::lround(meta.width * meta.scale);
+
+                // With a stride only pad up to the smallest multiple of it, like the "auto" mode of YOLO loaders
+                auto padHeight = targetHeight - resizedHeight;
+                auto padWidth = targetWidth - resizedWidth;
+
+                if (stride > 0)
+                {
+                    padHeight %= stride;
+                    padWidth %= stride;
+                }
+
+                meta.padTop = padHeight / 2;
+                meta.padLeft = padWidth / 2;
+
+                auto output = torch::full({batched.size(0), batched.size(1), resizedHeight + padHeight, resizedWidth + padWidth},
+                                          fill, batched.options());
+
+                auto resized = batched;
+
+                if (resizedHeight != meta.height || resizedWidth != meta.width)
+                {
+                    auto options = torch::nn::functional::InterpolateFuncOptions()
+                                       .size(std::vector<int64_t>({resizedHeight, resizedWidth}))
+                                       .mode(torch::kBilinear)
+                                       .align_corners(false);
+
+                    if (batched.is_floating_point())
+                    {
+                        resized = torch::nn::functional::interpolate(batched, options);
+                    }
+                    else
+                    {
+                        resized = torch::nn::functional::interpolate(batched.to(torch::kFloat), options).round_().to(batched.scalar_type());
+                    }
+                }
+
+                output.narrow(2, meta.padTop, resizedHeight).narrow(3, meta.padLeft, resizedWidth).copy_(resized);
+
+                return {image.dim() == 4 ? output : output.squeeze(0), meta};
+            }
+
+            torch::Tensor groupedNms(const torch::Tensor &boxes, const torch::Tensor &scores, const torch::Tensor &groups, double iouThreshold)
+            {
+                if (boxes.size(0) == 0)
+                {
+                    return torch::empty({0}, torch::kLong);
+                }
+
+                auto offsets = groups.to(boxes.scalar_type()) * (boxes.max() + 1);
+
+                return torchvision_ops::nms(boxes + offsets.unsqueeze(1), scores, iouThreshold);
+            }
+
+            std::vector<Detections> decodeOutput(const torch::Tensor &output, const DecodeOptions &options)
+            {
+                auto batched = output.dim() == 3 ? output : output.unsqueeze(0);
+                auto data = batched.to(torch::kCPU, torch::kFloat).contiguous();
+
+                // yolov8 is [N, 4 + classes, anchors], the others are [N, anchors, 4 (+ objectness) + classes]
+                auto classStart = options.format == DetectionFormat::YoloV5 ? 5 : 4;
+                auto anchors = options.format == DetectionFormat::YoloV8 ? data.size(2) : data.size(1);
+                auto rowLength = options.format == DetectionFormat::YoloV8 ? data.size(1) : data.size(2);
+                auto numClasses = rowLength - classStart;
+                auto confThreshold = float(options.confThreshold);
+
+                if (numClasses <= 0)
+                {
+                    throw std::runtime_error("Detection output has no class scores");
+                }
+
+                std::vector<Detections> result;
+
+                for (int64_t n = 0; n < data.size(0); n++)
+                {
+                    const float *base = data[n].data_ptr<float>();
+
+                    std::vector<float> boxes;
+                    std::vector<float> scores;
+                    std::vector<int64_t> classes;
+
+                    auto pushBox = [&](float a, float b, float c, float d, float score, int64_t cls)
+                    {
+                        if (options.format == DetectionFormat::Xyxy)
+                        {
+                            boxes.insert(boxes.end(), {a, b, c, d});
+                        }
+                        else
+                        {
+                            boxes.insert(boxes.end(), {a - c / 2, b - d / 2, a + c / 2, b + d / 2});
+                        }
+                        scores.push_back(score);
+                        classes.push_back(cls);
+                    };
+
+                    if (options.format == DetectionFormat::YoloV8)
+                    {
+                        // Walk class rows instead of anchor columns so every read is sequential
+                        std::vector<float> best(anchors, -std::numeric_limits<float>::infinity());
+                        std::vector<int64_t> bestClass(anchors, 0);
+
+                        for (int64_t c = 0; c < numClasses; c++)
+                        {
+                            const float *row = base + (classStart + c) * anchors;
+                            for (int64_t a = 0; a < anchors; a++)
+                            {
+                                if (row[a] > best[a])
+                                {
+                                    best[a] = row[a];
+                                    bestClass[a] = c;
+                                }
+                            }
+                        }
+
+                        for (int64_t a = 0; a < anchors; a++)
+                        {
+                            if (best[a] > confThreshold)
+                            {
+                                pushBox(base[a], base[anchors + a], base[2 * anchors + a], base[3 * anchors + a], best[a], bestClass[a]);
+                            }
+                        }
+                    }
+                    else
+                    {
+                        for (int64_t a = 0; a < anchors; a++)
+                        {
+                            const float *row = base + a * rowLength;
+                            float objectness = options.format == DetectionFormat::YoloV5 ? row[4] : 1.0f;
+
+                            if (objectness <= confThreshold)
+                            {
+                                continue;
+                            }
+
+                            auto bestScore = row[classStart];
+                            int64_t bestClass = 0;
+                            for (int64_t c = 1; c < numClasses; c++)
+                            {
+                                if (row[classStart + c] > bestScore)
+                                {
+                                    bestScore = row[classStart + c];
+                                    bestClass = c;
+                                }
+                            }
+
+                            bestScore *= objectness;
+                            if (bestScore > confThreshold)
+                            {
+                                pushBox(row[0], row[1], row[2], row[3], bestScore, bestClass);
+                            }
+                        }
+                    }
+
+                    int64_t count = scores.size();
+                    auto boxTensor = torch::from_blob(boxes.data(), {count, 4}, torch::kFloat).clone();
+                    auto scoreTensor = torch::from_blob(scores.data(), {count}, torch::kFloat).clone();
+                    auto classTensor = torch::from_blob(classes.data(), {count}, torch::kLong).clone();
+
+                    if (count > options.maxCandidates)
+                    {
+                        auto top = std::get<1>(scoreTensor.topk(options.maxCandidates));
+                        boxTensor = boxTensor.index_select(0, top);
+                        scoreTensor = scoreTensor.index_select(0, top);
+                        classTensor = classTensor.index_select(0, top);
+                    }
+
+                    auto keep = options.classAgnostic ? torchvision_ops::nms(boxTensor, scoreTensor, options.iouThreshold)
+                                                      : groupedNms(boxTensor, scoreTensor, classTensor, options.iouThreshold);
+
+                    keep = keep.narrow(0, 0, std::min(keep.size(0), options.maxDetections));
+
+                    Detections detections;
+                    detections.boxes = boxTensor.index_select(0, keep);
+                    detections.scores = scoreTensor.index_select(0, keep);
+                    detections.classes = classTensor.index_select(0, keep);
+
+                    if (options.letterbox.has_value())
+                    {
+                        auto &meta = options.letterbox.value();
+                        auto padding = torch::tensor({float(meta.padLeft), float(meta.padTop), float(meta.padLeft), float(meta.padTop)});
+
+                        detections.boxes = (detections.boxes - padding) / meta.scale;
+                        detections.boxes.select(1, 0).clamp_(0, meta.width);
+                        detections.boxes.select(1, 1).clamp_(0, meta.height);
+                        detections.boxes.select(1, 2).clamp_(0, meta.width);
+                        detections.boxes.select(1, 3).clamp_(0, meta.height);
+                    }
+
+                    result.push_back(detections);
+                }
+
+                return result;
+            }
+
+            DecodeOptions decodeOptionsFromObject(const Napi::Object &obj)
+            {
+                DecodeOptions options;
+
+                if (obj.Has("format"))
+                {
+                    auto format = obj.Get("format").ToString().Utf8Value();
+
+                    if (format == "yolov5")
+                    {
+                        options.format = DetectionFormat::YoloV5;
+                    }
+                    else if (format == "yolov8")
+                    {
+                        options.format = DetectionFormat::YoloV8;
+                    }
+                    else if (format == "xyxy")
+                    {
+                        options.format = DetectionFormat::Xyxy;
+                    }
+                    else
+                    {
+                        throw std::runtime_error("Unknown detection format " + format);
+                    }
+                }
+
+                if (obj.Has("confThreshold"))
+                {
+                    options.confThreshold = obj.Get("confThreshold").ToNumber().DoubleValue();
+                }
+
+                if (obj.Has("iouThreshold"))
+                {
+                    options.iouThreshold = obj.Get("iouThreshold").ToNumber().DoubleValue();
+                }
+
+                if (obj.Has("maxCandidates"))
+                {
+                    options.maxCandidates = obj.Get("maxCandidates").ToNumber().Int64Value();
+                }
+
+                if (obj.Has("maxDetections"))
+                {
+                    options.maxDetections = obj.Get("maxDetections").ToNumber().Int64Value();
+                }
+
+                if (obj.Has("classAgnostic"))
+                {
+                    options.classAgnostic = obj.Get("classAgnostic").ToBoolean().Value();
+                }
+
+                if (obj.Has("letterboxMeta") && obj.Get("letterboxMeta").IsObject())
+                {
+                    options.letterbox = letterboxMetaFromObject(obj.Get("letterboxMeta").ToObject());
+                }
+
+                return options;
+            }
+
+            Napi::Object detectionsToObject(Napi::Env env, const Detections &detections)
+            {
+                auto result = Napi::Object::New(env);
+                result.Set("boxes", nodeml_torch::Tensor::FromTorchTensor(env, detections.boxes));
+                result.Set("scores", nodeml_torch::Tensor::FromTorchTensor(env, detections.scores));
+                result.Set("classes", nodeml_torch::Tensor::FromTorchTensor(env, detections.classes));
+                return result;
+            }
+
+            torch::Tensor convertBoxes(const torch::Tensor &boxes, const std::string &inFormat, const std::string &outFormat)
+            {
+                if (inFormat == outFormat)
+                {
+                    return boxes.clone();
+                }
+
+                auto xyxy = boxes;
+                auto parts = boxes.unbind(-1);
+
+                if (inFormat == "xywh")
+                {
+                    xyxy = torch::stack({parts[0], parts[1], parts[0] + parts[2], parts[1] + parts[3]}, -1);
+                }
+                else if (inFormat == "cxcywh")
+                {
+                    xyxy = torch::stack({parts[0] - parts[2] / 2, parts[1] - parts[3] / 2, parts[0] + parts[2] / 2, parts[1] + parts[3] / 2}, -1);
+                }
+                else if (inFormat != "xyxy")
+                {
+                    throw std::runtime_error("Unknown box format " + inFormat);
+                }
+
+                parts = xyxy.unbind(-1);
+
+                if (outFormat == "xyxy")
+                {
+                    return xyxy;
+                }
+                else if (outFormat == "xywh")
+                {
+                    return torch::stack({parts[0], parts[1], parts[2] - parts[0], parts[3] - parts[1]}, -1);
+                }
+                else if (outFormat == "cxcywh")
+                {
+                    return torch::stack({(parts[0] + parts[2]) / 2, (parts[1] + parts[3]) / 2, parts[2] - parts[0], parts[3] - parts[1]}, -1);
+                }
+
+                throw std::runtime_error("Unknown box format " + outFormat);
+            }
+
+            // Accepts either a [K, 5] (batchIndex, x1, y1, x2, y2) tensor or one [Ki, 4] tensor per image
+            static torch::Tensor roisFromValue(const Napi::Value &value)
+            {
+                if (!value.IsArray())
+                {
+                    return nodeml_torch::Tensor::FromObject(value)->torchTensor;
+                }
+
+                auto perImage = utils::napiArrayToVector<torch::Tensor>(value.As<Napi::Array>());
+
+                std::vector<torch::Tensor> rois;
+                for (size_t i = 0; i < perImage.size(); i++)
+                {
+                    auto &boxes = perImage.at(i);
+                    rois.push_back(torch::cat({torch::full({boxes.size(0), 1}, int64_t(i), boxes.options()), boxes}, 1));
+                }
+
+                return torch::cat(rois);
+            }
+
+            static std::vector<int64_t> outputSizeFromValue(const Napi::Value &value)
+            {
+                if (value.IsArray())
+                {
+                    return utils::napiArrayToVector<int64_t>(value.As<Napi::Array>());
+                }
+
+                auto size = value.ToNumber().Int64Value();
+                return {size, size};
+            }
+
+            static Napi::Value queueTensorWork(Napi::Env env, std::function<torch::Tensor()> work)
+            {
+                auto worker = new FunctionWorker<torch::Tensor>(
+                    env,
+                    work,
+                    [=](Napi::Env env, torch::Tensor value) -> Napi::Value
+                    {
+                        return nodeml_torch::Tensor::FromTorchTensor(env, value);
+                    });
+
+                worker->Queue();
+
+                return worker->GetPromise();
+            }
+
+            Napi::Object letterboxMetaToObject(Napi::Env env, const LetterboxMeta &meta)
+            {
+                auto result = Napi::Object::New(env);
+                result.Set("scale", meta.scale);
+                result.Set("padLeft", meta.padLeft);
+                result.Set("padTop", meta.padTop);
+                result.Set("width", meta.width);
+                result.Set("height", meta.height);
+                return result;
+            }
+
+            LetterboxMeta letterboxMetaFromObject(const Napi::Object &obj)
+            {
+                LetterboxMeta meta;
+                meta.scale = obj.Get("scale").ToNumber().DoubleValue();
+                meta.padLeft = obj.Get("padLeft").ToNumber().Int64Value();
+                meta.padTop = obj.Get("padTop").ToNumber().Int64Value();
+                meta.width = obj.Get("width").ToNumber().Int64Value();
+                meta.height = obj.Get("height").ToNumber().Int64Value();
+                return meta;
+            }
+
             Napi::Value nms(const Napi::CallbackInfo &info)
             {
                 auto env = info.Env();
@@ -30,12 +426,609 @@ namespace nodeml_torch
                 }
             }
 
+            Napi::Value letterbox(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    auto image = nodeml_torch::Tensor::FromObject(info[0])->torchTensor;
+
+                    int64_t targetHeight = 640;
+                    int64_t targetWidth = 640;
+                    double fill = 114;
+                    int64_t stride = 0;
+                    bool scaleUp = true;
+
+                    if (info.Length() >= 2 && info[1].IsObject())
+                    {
+                        auto options = info[1].ToObject();
+
+                        if (options.Has("size"))
+                        {
+                            auto size = options.Get("size");
+                            if (size.IsArray())
+                            {
+                                auto sizes = utils::napiArrayToVector<int64_t>(size.As<Napi::Array>());
+                                targetHeight = sizes.at(0);
+                                targetWidth = sizes.at(1);
+                            }
+                            else
+                            {
+                                targetHeight = targetWidth = size.ToNumber().Int64Value();
+                            }
+                        }
+
+                        if (options.Has("fill"))
+                        {
+                            fill = options.Get("fill").ToNumber().DoubleValue();
+                        }
+
+                        if (options.Has("stride"))
+                        {
+                            stride = options.Get("stride").ToNumber().Int64Value();
+                        }
+
+                        if (options.Has("scaleUp"))
+                        {
+                            scaleUp = options.Get("scaleUp").ToBoolean().Value();
+                        }
+                    }
+
+                    auto worker = new FunctionWorker<std::tuple<torch::Tensor, LetterboxMeta>>(
+                        env,
+                        [=]() -> std::tuple<torch::Tensor, LetterboxMeta>
+                        {
+                            return letterboxImage(image, targetHeight, targetWidth, fill, stride, scaleUp);
+                        },
+                        [=](Napi::Env env, std::tuple<torch::Tensor, LetterboxMeta> value) -> Napi::Value
+                        {
+                            auto result = Napi::Object::New(env);
+                            result.Set("tensor", nodeml_torch::Tensor::FromTorchTensor(env, std::get<0>(value)));
+                            result.Set("meta", letterboxMetaToObject(env, std::get<1>(value)));
+                            return result;
+                        });
+
+                    worker->Queue();
+
+                    return worker->GetPromise();
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Value batchedNms(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    auto boxes = nodeml_torch::Tensor::FromObject(info[0])->torchTensor;
+                    auto scores = nodeml_torch::Tensor::FromObject(info[1])->torchTensor;
+                    auto count = boxes.size(0);
+
+                    auto classIdxs = info.Length() >= 3 && info[2].IsObject()
+                                         ? nodeml_torch::Tensor::FromObject(info[2])->torchTensor.to(torch::kLong)
+                                         : torch::zeros({count}, torch::kLong);
+
+                    auto batchIdxs = info.Length() >= 4 && info[3].IsObject()
+                                         ? nodeml_torch::Tensor::FromObject(info[3])->torchTensor.to(torch::kLong)
+                                         : torch::zeros({count}, torch::kLong);
+
+                    double iouThreshold = 0.5;
+                    c10::optional<double> scoreThreshold;
+                    int64_t maxPerImage = -1;
+                    int64_t maxTotal = -1;
+                    int64_t maxCandidates = -1;
+                    int64_t numImages = -1;
+
+                    if (info.Length() >= 5 && info[4].IsObject())
+                    {
+                        auto options = info[4].ToObject();
+
+                        if (options.Has("iouThreshold"))
+                        {
+                            iouThreshold = options.Get("iouThreshold").ToNumber().DoubleValue();
+                        }
+
+                        if (options.Has("scoreThreshold"))
+                        {
+                            scoreThreshold = options.Get("scoreThreshold").ToNumber().DoubleValue();
+                        }
+
+                        if (options.Has("maxPerImage"))
+                        {
+                            maxPerImage = options.Get("maxPerImage").ToNumber().Int64Value();
+                        }
+
+                        if (options.Has("maxTotal"))
+                        {
+                            maxTotal = options.Get("maxTotal").ToNumber().Int64Value();
+                        }
+
+                        if (options.Has("maxCandidates"))
+                        {
+                            maxCandidates = options.Get("maxCandidates").ToNumber().Int64Value();
+                        }
+
+                        if (options.Has("numImages"))
+                        {
+                            numImages = options.Get("numImages").ToNumber().Int64Value();
+                        }
+                    }
+
+                    auto worker = new FunctionWorker<std::vector<torch::Tensor>>(
+                        env,
+                        [=]() -> std::vector<torch::Tensor>
+                        {
+                            auto candidates = scoreThreshold.has_value()
+                                                  ? torch::nonzero(scores > scoreThreshold.value()).squeeze(1)
+                                                  : torch::arange(count, torch::kLong);
+
+                            auto numClasses = count == 0 ? 1 : classIdxs.max().item<int64_t>() + 1;
+                            auto images = numImages >= 0 ? numImages : (count == 0 ? 0 : batchIdxs.max().item<int64_t>() + 1);
+
+                            // Top-k per image before NMS, so a low threshold does not hand every candidate to groupedNms
+                            if (maxCandidates >= 0 && candidates.numel() > maxCandidates)
+                            {
+                                auto order = std::get<1>(scores.index_select(0, candidates).sort(0, true));
+                                auto sorted = candidates.index_select(0, order).contiguous();
+                                auto sortedBatches = batchIdxs.index_select(0, sorted).contiguous();
+                                auto sortedPtr = sorted.data_ptr<int64_t>();
+                                auto sortedBatchPtr = sortedBatches.data_ptr<int64_t>();
+
+                                std::vector<int64_t> taken(images, 0);
+                                std::vector<int64_t> selected;
+                                for (int64_t i = 0; i < sorted.numel(); i++)
+                                {
+                                    auto image = sortedBatchPtr[i];
+                                    if (image >= 0 && image < images && taken[image] < maxCandidates)
+                                    {
+                                        taken[image]++;
+                                        selected.push_back(sortedPtr[i]);
+                                    }
+                                }
+
+                                candidates = torch::tensor(selected, torch::kLong);
+                            }
+
+                            auto candidateBatches = batchIdxs.index_select(0, candidates);
+                            auto candidateClasses = classIdxs.index_select(0, candidates);
+
+                            // keep is sorted by descending score, so both caps can be applied in one sweep
+                            auto keep = candidates.index_select(
+                                                       0, groupedNms(boxes.index_select(0, candidates), scores.index_select(0, candidates),
+                                                                     candidateBatches * numClasses + candidateClasses, iouThreshold))
+                                            .contiguous();
+
+                            auto keptBatches = batchIdxs.index_select(0, keep).contiguous();
+                            auto keepPtr = keep.data_ptr<int64_t>();
+                            auto batchPtr = keptBatches.data_ptr<int64_t>();
+
+                            std::vector<std::vector<int64_t>> perImage(images);
+                            int64_t total = 0;
+
+                            for (int64_t i = 0; i < keep.numel() && (maxTotal < 0 || total < maxTotal); i++)
+                            {
+                                auto image = batchPtr[i];
+                                if (image < 0 || image >= images)
+                                {
+                                    continue;
+                                }
+
+                                auto &kept = perImage.at(image);
+                                if (maxPerImage < 0 || int64_t(kept.size()) < maxPerImage)
+                                {
+                                    kept.push_back(keepPtr[i]);
+                                    total++;
+                                }
+                            }
+
+                            std::vector<torch::Tensor> result;
+                            for (auto &kept : perImage)
+                            {
+                                result.push_back(torch::tensor(kept, torch::kLong));
+                            }
+
+                            return result;
+                        },
+                        [=](Napi::Env env, std::vector<torch::Tensor> value) -> Napi::Value
+                        {
+                            return utils::vectorToNapiArray(env, value);
+                        });
+
+                    worker->Queue();
+
+                    return worker->GetPromise();
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Value decodeDetections(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    auto output = nodeml_torch::Tensor::FromObject(info[0])->torchTensor;
+
+                    auto options = info.Length() >= 2 && info[1].IsObject() ? decodeOptionsFromObject(info[1].ToObject()) : DecodeOptions();
+
+                    auto worker = new FunctionWorker<std::vector<Detections>>(
+                        env,
+                        [=]() -> std::vector<Detections>
+                        {
+                            return decodeOutput(output, options);
+                        },
+                        [=](Napi::Env env, std::vector<Detections> value) -> Napi::Value
+                        {
+                            auto result = Napi::Array::New(env, value.size());
+
+                            for (size_t i = 0; i < value.size(); i++)
+                            {
+                                result.Set(uint32_t(i), detectionsToObject(env, value.at(i)));
+                            }
+
+                            return result;
+                        });
+
+                    worker->Queue();
+
+                    return worker->GetPromise();
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Value roiAlign(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    auto input = nodeml_torch::Tensor::FromObject(info[0])->torchTensor;
+                    auto rois = roisFromValue(info[1]);
+
+                    std::vector<int64_t> outputSize = {7, 7};
+                    double spatialScale = 1.0;
+                    int64_t samplingRatio = -1;
+                    bool aligned = false;
+
+                    if (info.Length() >= 3 && info[2].IsObject())
+                    {
+                        auto options = info[2].ToObject();
+
+                        if (options.Has("outputSize"))
+                        {
+                            outputSize = outputSizeFromValue(options.Get("outputSize"));
+                        }
+
+                        if (options.Has("spatialScale"))
+                        {
+                            spatialScale = options.Get("spatialScale").ToNumber().DoubleValue();
+                        }
+
+                        if (options.Has("samplingRatio"))
+                        {
+                            samplingRatio = options.Get("samplingRatio").ToNumber().Int64Value();
+                        }
+
+                        if (options.Has("aligned"))
+                        {
+                            aligned = options.Get("aligned").ToBoolean().Value();
+                        }
+                    }
+
+                    return queueTensorWork(env, [=]() -> torch::Tensor
+                                           { return torchvision_ops::roi_align(input, rois.to(input.scalar_type()), spatialScale,
+                                                                               outputSize.at(0), outputSize.at(1), samplingRatio, aligned); });
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Value roiPool(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    auto input = nodeml_torch::Tensor::FromObject(info[0])->torchTensor;
+                    auto rois = roisFromValue(info[1]);
+
+                    std::vector<int64_t> outputSize = {7, 7};
+                    double spatialScale = 1.0;
+
+                    if (info.Length() >= 3 && info[2].IsObject())
+                    {
+                        auto options = info[2].ToObject();
+
+                        if (options.Has("outputSize"))
+                        {
+                            outputSize = outputSizeFromValue(options.Get("outputSize"));
+                        }
+
+                        if (options.Has("spatialScale"))
+                        {
+                            spatialScale = options.Get("spatialScale").ToNumber().DoubleValue();
+                        }
+                    }
+
+                    return queueTensorWork(env, [=]() -> torch::Tensor
+                                           { return std::get<0>(torchvision_ops::roi_pool(input, rois.to(input.scalar_type()), spatialScale,
+                                                                                          outputSize.at(0), outputSize.at(1))); });
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Value boxIou(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    auto a = nodeml_torch::Tensor::FromObject(info[0])->torchTensor;
+                    auto b = nodeml_torch::Tensor::FromObject(info[1])->torchTensor;
+
+                    return queueTensorWork(env, [=]() -> torch::Tensor
+                                           {
+                                               auto areaA = (a.select(1, 2) - a.select(1, 0)) * (a.select(1, 3) - a.select(1, 1));
+                                               auto areaB = (b.select(1, 2) - b.select(1, 0)) * (b.select(1, 3) - b.select(1, 1));
+
+                                               auto topLeft = torch::maximum(a.narrow(1, 0, 2).unsqueeze(1), b.narrow(1, 0, 2));
+                                               auto bottomRight = torch::minimum(a.narrow(1, 2, 2).unsqueeze(1), b.narrow(1, 2, 2));
+                                               auto size = (bottomRight - topLeft).clamp_min(0);
+                                               auto intersection = size.select(2, 0) * size.select(2, 1);
+
+                                               return intersection / (areaA.unsqueeze(1) + areaB - intersection); });
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Value boxConvert(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    auto boxes = nodeml_torch::Tensor::FromObject(info[0])->torchTensor;
+                    auto inFormat = info[1].ToString().Utf8Value();
+                    auto outFormat = info[2].ToString().Utf8Value();
+
+                    return queueTensorWork(env, [=]() -> torch::Tensor
+                                           { return convertBoxes(boxes, inFormat, outFormat); });
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Value clipBoxes(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    auto boxes = nodeml_torch::Tensor::FromObject(info[0])->torchTensor;
+                    auto size = utils::napiArrayToVector<int64_t>(info[1].As<Napi::Array>());
+                    auto height = size.at(0);
+                    auto width = size.at(1);
+
+                    return queueTensorWork(env, [=]() -> torch::Tensor
+                                           {
+                                               auto clipped = boxes.clone();
+                                               clipped.select(-1, 0).clamp_(0, width);
+                                               clipped.select(-1, 1).clamp_(0, height);
+                                               clipped.select(-1, 2).clamp_(0, width);
+                                               clipped.select(-1, 3).clamp_(0, height);
+                                               return clipped; });
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Value removeSmallBoxes(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    auto boxes = nodeml_torch::Tensor::FromObject(info[0])->torchTensor;
+                    auto minSize = info[1].ToNumber().DoubleValue();
+
+                    return queueTensorWork(env, [=]() -> torch::Tensor
+                                           {
+                                               auto widths = boxes.select(1, 2) - boxes.select(1, 0);
+                                               auto heights = boxes.select(1, 3) - boxes.select(1, 1);
+                                               return torch::nonzero((widths >= minSize).logical_and(heights >= minSize)).squeeze(1); });
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Value segmentationToMask(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    auto logits = nodeml_torch::Tensor::FromObject(info[0])->torchTensor;
+
+                    if (logits.dim() == 4)
+                    {
+                        if (logits.size(0) != 1)
+                        {
+                            throw Napi::Error::New(env, "segmentationToMask expects a single image");
+                        }
+                        logits = logits.squeeze(0);
+                    }
+
+                    int64_t outHeight = logits.size(1);
+                    int64_t outWidth = logits.size(2);
+                    std::vector<uint8_t> palette;
+                    bool png = false;
+
+                    if (info.Length() >= 2 && info[1].IsObject())
+                    {
+                        auto options = info[1].ToObject();
+
+                        if (options.Has("size"))
+                        {
+                            auto size = outputSizeFromValue(options.Get("size"));
+                            outHeight = size.at(0);
+                            outWidth = size.at(1);
+                        }
+
+                        if (options.Has("palette"))
+                        {
+                            auto value = options.Get("palette");
+
+                            if (value.IsTypedArray())
+                            {
+                                auto data = value.As<Napi::Uint8Array>();
+                                palette.assign(data.Data(), data.Data() + data.ElementLength());
+                            }
+                            else
+                            {
+                                auto colors = value.As<Napi::Array>();
+                                for (uint32_t i = 0; i < colors.Length(); i++)
+                                {
+                                    auto color = colors.Get(i);
+                                    if (color.IsArray())
+                                    {
+                                        for (auto channel : utils::napiArrayToVector<int64_t>(color.As<Napi::Array>(), 3))
+                                        {
+                                            palette.push_back(uint8_t(channel));
+                                        }
+                                    }
+                                    else
+                                    {
+                                        palette.push_back(uint8_t(color.ToNumber().Uint32Value()));
+                                    }
+                                }
+                            }
+
+                            if (palette.size() % 3 != 0)
+                            {
+                                throw Napi::Error::New(env, "Palette must contain RGB triplets");
+                            }
+                        }
+
+                        if (options.Has("format"))
+                        {
+                            png = options.Get("format").ToString().Utf8Value() == "png";
+                        }
+                    }
+
+                    auto worker = new FunctionWorker<torch::Tensor>(
+                        env,
+                        [=]() -> torch::Tensor
+                        {
+                            auto labels = logits.argmax(0).to(torch::kCPU, torch::kLong).contiguous();
+                            auto height = labels.size(0);
+                            auto width = labels.size(1);
+                            const int64_t *labelPtr = labels.data_ptr<int64_t>();
+
+                            // Nearest upsampling of the label map, same source pixel selection as interpolate's 'nearest' mode
+                            std::vector<int64_t> sourceRows(outHeight);
+                            std::vector<int64_t> sourceCols(outWidth);
+                            for (int64_t y = 0; y < outHeight; y++)
+                            {
+                                sourceRows[y] = std::min(int64_t(y * (double(height) / outHeight)), height - 1);
+                            }
+                            for (int64_t x = 0; x < outWidth; x++)
+                            {
+                                sourceCols[x] = std::min(int64_t(x * (double(width) / outWidth)), width - 1);
+                            }
+
+                            int64_t channels = palette.empty() ? 1 : 3;
+                            int64_t colors = palette.size() / 3;
+                            auto mask = torch::empty({outHeight, outWidth, channels}, torch::kUInt8);
+                            uint8_t *maskPtr = mask.data_ptr<uint8_t>();
+
+                            at::parallel_for(0, outHeight, 16, [&](int64_t begin, int64_t end)
+                                             {
+                                                 for (int64_t y = begin; y < end; y++)
+                                                 {
+                                                     const int64_t *sourceRow = labelPtr + sourceRows[y] * width;
+                                                     uint8_t *out = maskPtr + y * outWidth * channels;
+
+                                                     for (int64_t x = 0; x < outWidth; x++)
+                                                     {
+                                                         auto label = sourceRow[sourceCols[x]];
+
+                                                         if (channels == 1)
+                                                         {
+                                                             *out++ = uint8_t(label);
+                                                         }
+                                                         else
+                                                         {
+                                                             const uint8_t *color = palette.data() + (label % colors) * 3;
+                                                             *out++ = color[0];
+                                                             *out++ = color[1];
+                                                             *out++ = color[2];
+                                                         }
+                                                     }
+                                                 } });
+
+                            if (png)
+                            {
+                                return torchvision_io::encode_png(mask.permute({2, 0, 1}), 6);
+                            }
+
+                            return mask;
+                        },
+                        [=](Napi::Env env, torch::Tensor value) -> Napi::Value
+                        {
+                            return Napi::Buffer<uint8_t>::Copy(env, value.data_ptr<uint8_t>(), value.numel());
+                        });
+
+                    worker->Queue();
+
+                    return worker->GetPromise();
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
             Napi::Object Init(Napi::Env env, Napi::Object exports)
             {
                 auto myExports = Napi::Object::New(env);
 
                 myExports.Set("nms", Napi::Function::New(env, nms));
 
+                myExports.Set("letterbox", Napi::Function::New(env, letterbox));
+
+                myExports.Set("batchedNms", Napi::Function::New(env, batchedNms));
+
+                myExports.Set("decodeDetections", Napi::Function::New(env, decodeDetections));
+
+                myExports.Set("roiAlign", Napi::Function::New(env, roiAlign));
+
+                myExports.Set("roiPool", Napi::Function::New(env, roiPool));
+
+                myExports.Set("boxIou", Napi::Function::New(env, boxIou));
+
+                myExports.Set("boxConvert", Napi::Function::New(env, boxConvert));
+
+                myExports.Set("clipBoxes", Napi::Function::New(env, clipBoxes));
+
+                myExports.Set("removeSmallBoxes", Napi::Function::New(env, removeSmallBoxes));
+
+                myExports.Set("segmentationToMask", Napi::Function::New(env, segmentationToMask));
+
                 exports.Set("ops", myExports);
 
                 return exports;
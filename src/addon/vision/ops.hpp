@@ -1,6 +1,7 @@
 #pragma once
 
 #include <napi.h>
+#include <torch/torch.h>
 
 namespace nodeml_torch
 {
@@ -8,9 +9,82 @@ namespace nodeml_torch
     {
         namespace ops
         {
+            // Scale and padding applied by letterbox, needed to map boxes back to the source image
+            struct LetterboxMeta
+            {
+                double scale = 1.0;
+                int64_t padLeft = 0;
+                int64_t padTop = 0;
+                int64_t width = 0;
+                int64_t height = 0;
+            };
+
+            enum class DetectionFormat
+            {
+                YoloV5,
+                YoloV8,
+                Xyxy
+            };
+
+            struct DecodeOptions
+            {
+                DetectionFormat format = DetectionFormat::YoloV8;
+                double confThreshold = 0.25;
+                double iouThreshold = 0.45;
+                int64_t maxCandidates = 30000;
+                int64_t maxDetections = 300;
+                bool classAgnostic = false;
+                c10::optional<LetterboxMeta> letterbox;
+            };
+
+            struct Detections
+            {
+                torch::Tensor boxes;
+                torch::Tensor scores;
+                torch::Tensor classes;
+            };
+
+            std::tuple<torch::Tensor, LetterboxMeta> letterboxImage(const torch::Tensor &image, int64_t targetHeight, int64_t targetWidth,
+                                                                    double fill, int64_t stride, bool scaleUp);
+
+            // NMS that never suppresses across groups, by offsetting each group's boxes into a disjoint range
+            torch::Tensor groupedNms(const torch::Tensor &boxes, const torch::Tensor &scores, const torch::Tensor &groups, double iouThreshold);
+
+            std::vector<Detections> decodeOutput(const torch::Tensor &output, const DecodeOptions &options);
+
+            DecodeOptions decodeOptionsFromObject(const Napi::Object &obj);
+
+            Napi::Object detectionsToObject(Napi::Env env, const Detections &detections);
+
+            // Converts between 'xyxy', 'xywh' and 'cxcywh' box layouts
+            torch::Tensor convertBoxes(const torch::Tensor &boxes, const std::string &inFormat, const std::string &outFormat);
+
+            Napi::Object letterboxMetaToObject(Napi::Env env, const LetterboxMeta &meta);
+
+            LetterboxMeta letterboxMetaFromObject(const Napi::Object &obj);
 
             Napi::Value nms(const Napi::CallbackInfo &info);
 
+            Napi::Value letterbox(const Napi::CallbackInfo &info);
+
+            Napi::Value batchedNms(const Napi::CallbackInfo &info);
+
+            Napi::Value decodeDetections(const Napi::CallbackInfo &info);
+
+            Napi::Value roiAlign(const Napi::CallbackInfo &info);
+
+            Napi::Value roiPool(const Napi::CallbackInfo &info);
+
+            Napi::Value boxIou(const Napi::CallbackInfo &info);
+
+            Napi::Value boxConvert(const Napi::CallbackInfo &info);
+
+            Napi::Value clipBoxes(const Napi::CallbackInfo &info);
+
+            Napi::Value removeSmallBoxes(const Napi::CallbackInfo &info);
+
+            Napi::Value segmentationToMask(const Napi::CallbackInfo &info);
+
             Napi::Object Init(Napi::Env env, Napi::Object exports);
         }
     }
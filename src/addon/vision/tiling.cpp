@@ -0,0 +1,230 @@
+#include <napi.h>
+#include <addon/Tensor.hpp>
+#include <addon/AddonData.hpp>
+#include <addon/FunctionWorker.hpp>
+#include <addon/jit/Module.hpp>
+#include <addon/vision/ops.hpp>
+#include <addon/vision/tiling.hpp>
+#include <torch/torch.h>
+
+namespace nodeml_torch
+{
+    namespace vision
+    {
+        namespace tiling
+        {
+            // Tile origins along one axis, the last tile is pulled back so it ends on the border
+            static std::vector<int64_t> tileOrigins(int64_t length, int64_t tile, int64_t stride)
+            {
+                std::vector<int64_t> origins;
+
+                if (length <= tile)
+                {
+                    origins.push_back(0);
+                    return origins;
+                }
+
+                for (int64_t origin = 0;; origin += stride)
+                {
+                    if (origin + tile >= length)
+                    {
+                        origins.push_back(length - tile);
+                        break;
+                    }
+                    origins.push_back(origin);
+                }
+
+                return origins;
+            }
+
+            Napi::Value run(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    if (!info[0].IsObject() || !info[0].ToObject().InstanceOf(AddonData::Get(env)->jitModuleConstructor.Value()))
+                    {
+                        throw Napi::Error::New(env, "Expected A jit Module");
+                    }
+
+                    auto module = Napi::ObjectWrap<jit::JitModule>::Unwrap(info[0].ToObject())->torchModule;
+                    auto image = Tensor::FromObject(info[1])->torchTensor;
+                    if (module.is_training())
+                    {
+                        module.eval();
+                    }
+
+                    if (image.dim() == 4)
+                    {
+                        image = image.squeeze(0);
+                    }
+
+                    if (image.dim() != 3)
+                    {
+                        throw Napi::Error::New(env, "Tiling expects a single CHW image");
+                    }
+
+                    int64_t tileHeight = 640;
+                    int64_t tileWidth = 640;
+                    int64_t overlap = -1;
+                    int64_t batchSize = 4;
+                    double fill = 114;
+                    bool normalize = !image.is_floating_point();
+                    ops::DecodeOptions decodeOptions;
+
+                    if (info.Length() >= 3 && info[2].IsObject())
+                    {
+                        auto options = info[2].ToObject();
+
+                        if (options.Has("tileSize"))
+                        {
+                            auto size = options.Get("tileSize");
+                            if (size.IsArray())
+                            {
+                                auto sizes = size.As<Napi::Array>();
+                                tileHeight = sizes.Get(uint32_t(0)).ToNumber().Int64Value();
+                                tileWidth = sizes.Get(uint32_t(1)).ToNumber().Int64Value();
+                            }
+                            else
+                            {
+                                tileHeight = tileWidth = size.ToNumber().Int64Value();
+                            }
+                        }
+
+                        if (options.Has("overlap"))
+                        {
+                            overlap = options.Get("overlap").ToNumber().Int64Value();
+                        }
+
+                        if (options.Has("batchSize"))
+                        {
+                            batchSize = std::max<int64_t>(1, options.Get("batchSize").ToNumber().Int64Value());
+                        }
+
+                        if (options.Has("fill"))
+                        {
+                            fill = options.Get("fill").ToNumber().DoubleValue();
+                        }
+
+                        if (options.Has("normalize"))
+                        {
+                            normalize = options.Get("normalize").ToBoolean().Value();
+                        }
+
+                        decodeOptions = ops::decodeOptionsFromObject(options);
+                        decodeOptions.letterbox.reset();
+                    }
+
+                    if (overlap < 0)
+                    {
+                        overlap = std::min(tileHeight, tileWidth) / 5;
+                    }
+
+                    if (overlap >= tileHeight || overlap >= tileWidth)
+                    {
+                        throw Napi::Error::New(env, "Overlap must be smaller than the tile size");
+                    }
+
+                    auto worker = new FunctionWorker<ops::Detections>(
+                        env,
+                        [=]() -> ops::Detections
+                        {
+                            torch::NoGradGuard no_grad;
+                            auto model = module;
+
+                            auto height = image.size(1);
+                            auto width = image.size(2);
+                            auto rows = tileOrigins(height, tileHeight, tileHeight - overlap);
+                            auto cols = tileOrigins(width, tileWidth, tileWidth - overlap);
+
+                            std::vector<std::pair<int64_t, int64_t>> origins;
+                            for (auto y : rows)
+                            {
+                                for (auto x : cols)
+                                {
+                                    origins.emplace_back(y, x);
+                                }
+                            }
+
+                            std::vector<torch::Tensor> boxes;
+                            std::vector<torch::Tensor> scores;
+                            std::vector<torch::Tensor> classes;
+
+                            for (size_t start = 0; start < origins.size(); start += batchSize)
+                            {
+                                auto end = std::min(origins.size(), start + size_t(batchSize));
+                                auto batch = torch::full({int64_t(end - start), image.size(0), tileHeight, tileWidth}, fill, image.options());
+
+                                // Tiles are views into the image, the only copy is into the batch the model consumes
+                                for (size_t i = start; i < end; i++)
+                                {
+                                    auto [y, x] = origins.at(i);
+                                    auto tile = image.narrow(1, y, std::min(tileHeight, height)).narrow(2, x, std::min(tileWidth, width));
+                                    batch[int64_t(i - start)].narrow(1, 0, tile.size(1)).narrow(2, 0, tile.size(2)).copy_(tile);
+                                }
+
+                                auto input = normalize ? batch.to(torch::kFloat).div_(255) : batch;
+
+                                auto output = model.forward({input});
+                                auto prediction = output.isTuple() ? output.toTuple()->elements().at(0).toTensor() : output.toTensor();
+
+                                auto detections = ops::decodeOutput(prediction, decodeOptions);
+
+                                for (size_t i = start; i < end; i++)
+                                {
+                                    auto &tileDetections = detections.at(i - start);
+                                    auto [y, x] = origins.at(i);
+                                    auto offset = torch::tensor({float(x), float(y), float(x), float(y)});
+
+                                    boxes.push_back(tileDetections.boxes + offset);
+                                    scores.push_back(tileDetections.scores);
+                                    classes.push_back(tileDetections.classes);
+                                }
+                            }
+
+                            ops::Detections merged;
+                            merged.boxes = torch::cat(boxes);
+                            merged.scores = torch::cat(scores);
+                            merged.classes = torch::cat(classes);
+
+                            // Objects cut by a tile border are detected twice, once in each overlapping tile
+                            auto keep = decodeOptions.classAgnostic
+                                            ? ops::groupedNms(merged.boxes, merged.scores, torch::zeros_like(merged.classes), decodeOptions.iouThreshold)
+                                            : ops::groupedNms(merged.boxes, merged.scores, merged.classes, decodeOptions.iouThreshold);
+
+                            keep = keep.narrow(0, 0, std::min(keep.size(0), decodeOptions.maxDetections));
+
+                            merged.boxes = merged.boxes.index_select(0, keep);
+                            merged.scores = merged.scores.index_select(0, keep);
+                            merged.classes = merged.classes.index_select(0, keep);
+
+                            return merged;
+                        },
+                        [=](Napi::Env env, ops::Detections value) -> Napi::Value
+                        {
+                            return ops::detectionsToObject(env, value);
+                        });
+
+                    worker->Queue();
+
+                    return worker->GetPromise();
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Object Init(Napi::Env env, Napi::Object exports)
+            {
+                auto myExports = Napi::Object::New(env);
+
+                myExports.Set("run", Napi::Function::New(env, run));
+
+                exports.Set("tiling", myExports);
+
+                return exports;
+            }
+        }
+    }
+}
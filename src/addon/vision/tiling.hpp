@@ -0,0 +1,17 @@
+#pragma once
+
+#include <napi.h>
+
+namespace nodeml_torch
+{
+    namespace vision
+    {
+        namespace tiling
+        {
+
+            Napi::Value run(const Napi::CallbackInfo &info);
+
+            Napi::Object Init(Napi::Env env, Napi::Object exports);
+        }
+    }
+}
@@ -0,0 +1,472 @@
+#include <napi.h>
+#include <addon/Tensor.hpp>
+#include <addon/FunctionWorker.hpp>
+#include <addon/vision/transforms.hpp>
+#include <torch/torch.h>
+#include <torchvision/vision.h>
+#include <torchvision/ops/ops.h>
+
+#include <cmath>
+#include <random>
+
+namespace torchvision_ops = vision::ops;
+namespace nodeml_torch
+{
+    namespace vision
+    {
+        namespace transforms
+        {
+            namespace F = torch::nn::functional;
+
+            static constexpr double degreesToRadians = 3.14159265358979323846 / 180;
+
+            static std::mt19937_64 sampleGenerator(uint64_t seed, int64_t sample)
+            {
+                std::seed_seq sequence{uint32_t(seed), uint32_t(seed >> 32), uint32_t(sample)};
+                return std::mt19937_64(sequence);
+            }
+
+            static double uniform(std::mt19937_64 &generator, double low, double high)
+            {
+                return low == high ? low : std::uniform_real_distribution<double>(low, high)(generator);
+            }
+
+            static std::pair<double, double> rangeFromValue(const Napi::Value &value)
+            {
+                if (value.IsArray())
+                {
+                    auto range = value.As<Napi::Array>();
+                    return {range.Get(uint32_t(0)).ToNumber().DoubleValue(), range.Get(uint32_t(1)).ToNumber().DoubleValue()};
+                }
+
+                auto number = value.ToNumber().DoubleValue();
+                return {number, number};
+            }
+
+            static torch::Tensor grayscale(const torch::Tensor &x)
+            {
+                if (x.size(1) == 3)
+                {
+                    return (x.select(1, 0) * 0.299 + x.select(1, 1) * 0.587 + x.select(1, 2) * 0.114).unsqueeze(1);
+                }
+
+                return x.mean(1, true);
+            }
+
+            static torch::Tensor randomResizedCropBatch(const torch::Tensor &x, const TransformSpec &spec, uint64_t seed)
+            {
+                auto n = x.size(0);
+                auto height = x.size(2);
+                auto width = x.size(3);
+                auto rois = torch::empty({n, 5}, torch::kFloat);
+                auto roisAccessor = rois.accessor<float, 2>();
+
+                for (int64_t i = 0; i < n; i++)
+                {
+                    auto generator = sampleGenerator(seed, i);
+                    int64_t cropHeight = height;
+                    int64_t cropWidth = width;
+                    int64_t top = 0;
+                    int64_t left = 0;
+
+                    // Same rejection sampling as torchvision, falling back to the whole image
+                    for (int attempt = 0; attempt < 10; attempt++)
+                    {
+                        auto area = height * width * uniform(generator, spec.scaleMin, spec.scaleMax);
+                        auto ratio = std::exp(uniform(generator, std::log(spec.ratioMin), std::log(spec.ratioMax)));
+                        int64_t w = std::lround(std::sqrt(area * ratio));
+                        int64_t h = std::lround(std::sqrt(area / ratio));
+
+                        if (w > 0 && h > 0 && w <= width && h <= height)
+                        {
+                            cropHeight = h;
+                            cropWidth = w;
+                            top = std::uniform_int_distribution<int64_t>(0, height - h)(generator);
+                            left = std::uniform_int_distribution<int64_t>(0, width - w)(generator);
+                            break;
+                        }
+                    }
+
+                    roisAccessor[i][0] = i;
+                    roisAccessor[i][1] = left;
+                    roisAccessor[i][2] = top;
+                    roisAccessor[i][3] = left + cropWidth;
+                    roisAccessor[i][4] = top + cropHeight;
+                }
+
+                // One roi_align call crops and resizes every sample of the batch
+                return torchvision_ops::roi_align(x, rois.to(x.scalar_type()), 1.0, spec.height, spec.width, 2, true);
+            }
+
+            static torch::Tensor horizontalFlipBatch(const torch::Tensor &x, const TransformSpec &spec, uint64_t seed)
+            {
+                auto n = x.size(0);
+                auto flags = torch::empty({n}, torch::kBool);
+                auto flagsAccessor = flags.accessor<bool, 1>();
+
+                for (int64_t i = 0; i < n; i++)
+                {
+                    auto generator = sampleGenerator(seed, i);
+                    flagsAccessor[i] = uniform(generator, 0, 1) < spec.p;
+                }
+
+                return torch::where(flags.view({-1, 1, 1, 1}), x.flip({3}), x);
+            }
+
+            static torch::Tensor colorJitterBatch(const torch::Tensor &x, const TransformSpec &spec, uint64_t seed, double maxValue)
+            {
+                auto n = x.size(0);
+                std::vector<float> brightness(n, 1);
+                std::vector<float> contrast(n, 1);
+                std::vector<float> saturation(n, 1);
+
+                for (int64_t i = 0; i < n; i++)
+                {
+                    auto generator = sampleGenerator(seed, i);
+                    brightness[i] = uniform(generator, std::max(0.0, 1 - spec.brightness), 1 + spec.brightness);
+                    contrast[i] = uniform(generator, std::max(0.0, 1 - spec.contrast), 1 + spec.contrast);
+                    saturation[i] = uniform(generator, std::max(0.0, 1 - spec.saturation), 1 + spec.saturation);
+                }
+
+                auto result = x;
+
+                if (spec.brightness > 0)
+                {
+                    result = (result * torch::tensor(brightness).view({-1, 1, 1, 1})).clamp(0, maxValue);
+                }
+
+                if (spec.contrast > 0)
+                {
+                    auto mean = grayscale(result).mean({1, 2, 3}, true);
+                    result = ((result - mean) * torch::tensor(contrast).view({-1, 1, 1, 1}) + mean).clamp(0, maxValue);
+                }
+
+                if (spec.saturation > 0 && result.size(1) == 3)
+                {
+                    auto gray = grayscale(result);
+                    result = ((result - gray) * torch::tensor(saturation).view({-1, 1, 1, 1}) + gray).clamp(0, maxValue);
+                }
+
+                return result;
+            }
+
+            static torch::Tensor affineBatch(const torch::Tensor &x, const TransformSpec &spec, uint64_t seed)
+            {
+                auto n = x.size(0);
+                double halfHeight = x.size(2) / 2.0;
+                double halfWidth = x.size(3) / 2.0;
+                auto theta = torch::empty({n, 2, 3}, torch::kFloat);
+                auto thetaAccessor = theta.accessor<float, 3>();
+
+                for (int64_t i = 0; i < n; i++)
+                {
+                    auto generator = sampleGenerator(seed, i);
+                    auto angle = uniform(generator, -spec.degrees, spec.degrees) * degreesToRadians;
+                    auto shear = std::tan(uniform(generator, -spec.shear, spec.shear) * degreesToRadians);
+                    auto zoom = uniform(generator, spec.zoomMin, spec.zoomMax);
+                    auto tx = uniform(generator, -spec.translate, spec.translate) * x.size(3);
+                    auto ty = uniform(generator, -spec.translate, spec.translate) * x.size(2);
+
+                    // Forward map in centered pixel space is zoom * rotation * shear, grid_sample needs its inverse
+                    auto m00 = zoom * std::cos(angle);
+                    auto m01 = zoom * (std::cos(angle) * shear - std::sin(angle));
+                    auto m10 = zoom * std::sin(angle);
+                    auto m11 = zoom * (std::sin(angle) * shear + std::cos(angle));
+                    auto det = m00 * m11 - m01 * m10;
+                    auto i00 = m11 / det;
+                    auto i01 = -m01 / det;
+                    auto i10 = -m10 / det;
+                    auto i11 = m00 / det;
+
+                    // Rescale into affine_grid's normalized [-1, 1] coordinates
+                    thetaAccessor[i][0][0] = i00;
+                    thetaAccessor[i][0][1] = i01 * halfHeight / halfWidth;
+                    thetaAccessor[i][0][2] = -(i00 * tx + i01 * ty) / halfWidth;
+                    thetaAccessor[i][1][0] = i10 * halfWidth / halfHeight;
+                    thetaAccessor[i][1][1] = i11;
+                    thetaAccessor[i][1][2] = -(i10 * tx + i11 * ty) / halfHeight;
+                }
+
+                auto grid = F::affine_grid(theta.to(x.scalar_type()), x.sizes(), false);
+                return torch::grid_sampler(x, grid, 0, 0, false);
+            }
+
+            static torch::Tensor gaussianBlurBatch(const torch::Tensor &x, const TransformSpec &spec, uint64_t seed)
+            {
+                auto n = x.size(0);
+                auto channels = x.size(1);
+                auto kernelSize = spec.kernelSize | 1;
+                auto half = kernelSize / 2;
+                std::vector<float> sigmas(n);
+
+                for (int64_t i = 0; i < n; i++)
+                {
+                    auto generator = sampleGenerator(seed, i);
+                    sigmas[i] = uniform(generator, spec.sigmaMin, spec.sigmaMax);
+                }
+
+                auto coords = torch::arange(kernelSize, torch::kFloat) - half;
+                auto sigma = torch::tensor(sigmas).view({-1, 1});
+                auto kernel = torch::exp(-coords.pow(2).unsqueeze(0) / (2 * sigma.pow(2)));
+                kernel = (kernel / kernel.sum(1, true)).repeat_interleave(channels, 0).to(x.scalar_type());
+
+                // Every (sample, channel) plane gets its own kernel through a grouped separable convolution
+                auto groups = n * channels;
+                auto planes = F::pad(x.reshape({1, groups, x.size(2), x.size(3)}),
+                                     F::PadFuncOptions({half, half, half, half}).mode(torch::kReflect));
+                planes = F::conv2d(planes, kernel.view({groups, 1, kernelSize, 1}), F::Conv2dFuncOptions().groups(groups));
+                planes = F::conv2d(planes, kernel.view({groups, 1, 1, kernelSize}), F::Conv2dFuncOptions().groups(groups));
+
+                return planes.view(x.sizes());
+            }
+
+            TransformSpec transformSpecFromObject(const std::string &type, const Napi::Object &obj)
+            {
+                TransformSpec spec;
+                spec.type = type;
+
+                if (obj.Has("p"))
+                {
+                    spec.p = obj.Get("p").ToNumber().DoubleValue();
+                }
+
+                if (obj.Has("size"))
+                {
+                    auto size = obj.Get("size");
+                    if (size.IsArray())
+                    {
+                        auto sizes = size.As<Napi::Array>();
+                        spec.height = sizes.Get(uint32_t(0)).ToNumber().Int64Value();
+                        spec.width = sizes.Get(uint32_t(1)).ToNumber().Int64Value();
+                    }
+                    else
+                    {
+                        spec.height = spec.width = size.ToNumber().Int64Value();
+                    }
+                }
+
+                if (obj.Has("scale"))
+                {
+                    auto [low, high] = rangeFromValue(obj.Get("scale"));
+                    if (type == "affine")
+                    {
+                        spec.zoomMin = low;
+                        spec.zoomMax = high;
+                    }
+                    else
+                    {
+                        spec.scaleMin = low;
+                        spec.scaleMax = high;
+                    }
+                }
+
+                if (obj.Has("ratio"))
+                {
+                    std::tie(spec.ratioMin, spec.ratioMax) = rangeFromValue(obj.Get("ratio"));
+                }
+
+                if (obj.Has("brightness"))
+                {
+                    spec.brightness = obj.Get("brightness").ToNumber().DoubleValue();
+                }
+
+                if (obj.Has("contrast"))
+                {
+                    spec.contrast = obj.Get("contrast").ToNumber().DoubleValue();
+                }
+
+                if (obj.Has("saturation"))
+                {
+                    spec.saturation = obj.Get("saturation").ToNumber().DoubleValue();
+                }
+
+                if (obj.Has("degrees"))
+                {
+                    spec.degrees = obj.Get("degrees").ToNumber().DoubleValue();
+                }
+
+                if (obj.Has("translate"))
+                {
+                    spec.translate = obj.Get("translate").ToNumber().DoubleValue();
+                }
+
+                if (obj.Has("shear"))
+                {
+                    spec.shear = obj.Get("shear").ToNumber().DoubleValue();
+                }
+
+                if (obj.Has("kernelSize"))
+                {
+                    spec.kernelSize = obj.Get("kernelSize").ToNumber().Int64Value();
+                }
+
+                if (obj.Has("sigma"))
+                {
+                    std::tie(spec.sigmaMin, spec.sigmaMax) = rangeFromValue(obj.Get("sigma"));
+                }
+
+                return spec;
+            }
+
+            torch::Tensor applyTransforms(const torch::Tensor &batch, const std::vector<TransformSpec> &specs, uint64_t seed)
+            {
+                auto input = batch.dim() == 3 ? batch.unsqueeze(0) : batch;
+                auto x = input.is_floating_point() ? input : input.to(torch::kFloat);
+                double maxValue = input.is_floating_point() ? 1.0 : 255.0;
+
+                for (size_t i = 0; i < specs.size(); i++)
+                {
+                    auto &spec = specs.at(i);
+                    // Decorrelate the streams of consecutive transforms
+                    auto transformSeed = seed + i * 0x9E3779B97F4A7C15ULL;
+
+                    if (spec.type == "randomResizedCrop")
+                    {
+                        x = randomResizedCropBatch(x, spec, transformSeed);
+                    }
+                    else if (spec.type == "horizontalFlip")
+                    {
+                        x = horizontalFlipBatch(x, spec, transformSeed);
+                    }
+                    else if (spec.type == "colorJitter")
+                    {
+                        x = colorJitterBatch(x, spec, transformSeed, maxValue);
+                    }
+                    else if (spec.type == "affine")
+                    {
+                        x = affineBatch(x, spec, transformSeed);
+                    }
+                    else if (spec.type == "gaussianBlur")
+                    {
+                        x = gaussianBlurBatch(x, spec, transformSeed);
+                    }
+                    else
+                    {
+                        throw std::runtime_error("Unknown transform " + spec.type);
+                    }
+                }
+
+                if (!input.is_floating_point())
+                {
+                    x = x.round().clamp(0, maxValue).to(input.scalar_type());
+                }
+
+                return batch.dim() == 3 ? x.squeeze(0) : x;
+            }
+
+            static uint64_t seedFromValue(const Napi::Value &value)
+            {
+                if (value.IsObject() && value.ToObject().Has("seed"))
+                {
+                    return value.ToObject().Get("seed").ToNumber().Int64Value();
+                }
+
+                return std::random_device()();
+            }
+
+            static Napi::Value queueTransforms(Napi::Env env, const torch::Tensor &batch, const std::vector<TransformSpec> &specs, uint64_t seed)
+            {
+                auto worker = new FunctionWorker<torch::Tensor>(
+                    env,
+                    [=]() -> torch::Tensor
+                    {
+                        torch::NoGradGuard no_grad;
+                        return applyTransforms(batch, specs, seed);
+                    },
+                    [=](Napi::Env env, torch::Tensor value) -> Napi::Value
+                    {
+                        return Tensor::FromTorchTensor(env, value);
+                    });
+
+                worker->Queue();
+
+                return worker->GetPromise();
+            }
+
+            static Napi::Value runTransform(const Napi::CallbackInfo &info, const std::string &type)
+            {
+                auto env = info.Env();
+                try
+                {
+                    auto batch = Tensor::FromObject(info[0])->torchTensor;
+                    auto options = info.Length() >= 2 && info[1].IsObject() ? info[1].ToObject() : Napi::Object::New(env);
+
+                    return queueTransforms(env, batch, {transformSpecFromObject(type, options)}, seedFromValue(options));
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Value randomResizedCrop(const Napi::CallbackInfo &info)
+            {
+                return runTransform(info, "randomResizedCrop");
+            }
+
+            Napi::Value horizontalFlip(const Napi::CallbackInfo &info)
+            {
+                return runTransform(info, "horizontalFlip");
+            }
+
+            Napi::Value colorJitter(const Napi::CallbackInfo &info)
+            {
+                return runTransform(info, "colorJitter");
+            }
+
+            Napi::Value affine(const Napi::CallbackInfo &info)
+            {
+                return runTransform(info, "affine");
+            }
+
+            Napi::Value gaussianBlur(const Napi::CallbackInfo &info)
+            {
+                return runTransform(info, "gaussianBlur");
+            }
+
+            Napi::Value apply(const Napi::CallbackInfo &info)
+            {
+                auto env = info.Env();
+                try
+                {
+                    auto batch = Tensor::FromObject(info[0])->torchTensor;
+                    auto list = info[1].As<Napi::Array>();
+
+                    std::vector<TransformSpec> specs;
+                    for (uint32_t i = 0; i < list.Length(); i++)
+                    {
+                        auto options = list.Get(i).ToObject();
+                        specs.push_back(transformSpecFromObject(options.Get("type").ToString().Utf8Value(), options));
+                    }
+
+                    return queueTransforms(env, batch, specs, seedFromValue(info.Length() >= 3 ? info[2] : env.Undefined()));
+                }
+                catch (const std::exception &e)
+                {
+                    throw Napi::Error::New(env, e.what());
+                }
+            }
+
+            Napi::Object Init(Napi::Env env, Napi::Object exports)
+            {
+                auto myExports = Napi::Object::New(env);
+
+                myExports.Set("randomResizedCrop", Napi::Function::New(env, randomResizedCrop));
+
+                myExports.Set("horizontalFlip", Napi::Function::New(env, horizontalFlip));
+
+                myExports.Set("colorJitter", Napi::Function::New(env, colorJitter));
+
+                myExports.Set("affine", Napi::Function::New(env, affine));
+
+                myExports.Set("gaussianBlur", Napi::Function::New(env, gaussianBlur));
+
+                myExports.Set("apply", Napi::Function::New(env, apply));
+
+                exports.Set("transforms", myExports);
+
+                return exports;
+            }
+        }
+    }
+}
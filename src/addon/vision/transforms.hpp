@@ -0,0 +1,65 @@
+#pragma once
+
+#include <napi.h>
+#include <torch/torch.h>
+
+namespace nodeml_torch
+{
+    namespace vision
+    {
+        namespace transforms
+        {
+            struct TransformSpec
+            {
+                std::string type;
+
+                // horizontalFlip
+                double p = 0.5;
+
+                // randomResizedCrop
+                int64_t height = 224;
+                int64_t width = 224;
+                double scaleMin = 0.08;
+                double scaleMax = 1.0;
+                double ratioMin = 3.0 / 4.0;
+                double ratioMax = 4.0 / 3.0;
+
+                // colorJitter
+                double brightness = 0;
+                double contrast = 0;
+                double saturation = 0;
+
+                // affine
+                double degrees = 0;
+                double translate = 0;
+                double zoomMin = 1.0;
+                double zoomMax = 1.0;
+                double shear = 0;
+
+                // gaussianBlur
+                int64_t kernelSize = 3;
+                double sigmaMin = 0.1;
+                double sigmaMax = 2.0;
+            };
+
+            TransformSpec transformSpecFromObject(const std::string &type, const Napi::Object &obj);
+
+            // Applies the transforms in order to a CHW or NCHW batch, every sample draws from its own seeded generator
+            torch::Tensor applyTransforms(const torch::Tensor &batch, const std::vector<TransformSpec> &specs, uint64_t seed);
+
+            Napi::Value randomResizedCrop(const Napi::CallbackInfo &info);
+
+            Napi::Value horizontalFlip(const Napi::CallbackInfo &info);
+
+            Napi::Value colorJitter(const Napi::CallbackInfo &info);
+
+            Napi::Value affine(const Napi::CallbackInfo &info);
+
+            Napi::Value gaussianBlur(const Napi::CallbackInfo &info);
+
+            Napi::Value apply(const Napi::CallbackInfo &info);
+
+            Napi::Object Init(Napi::Env env, Napi::Object exports);
+        }
+    }
+}
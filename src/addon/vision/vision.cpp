@@ -3,6 +3,8 @@
 #include <torch/torch.h>
 #include <addon/vision/ops.hpp>
 #include <addon/vision/io.hpp>
+#include <addon/vision/tiling.hpp>
+#include <addon/vision/transforms.hpp>
 
 namespace nodeml_torch
 {
@@ -15,6 +17,8 @@ namespace nodeml_torch
 
             ops::Init(env, myExports);
             io::Init(env, myExports);
+            tiling::Init(env, myExports);
+            transforms::Init(env, myExports);
 
             exports.Set("vision", myExports);
 